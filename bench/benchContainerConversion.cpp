@@ -0,0 +1,107 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+namespace
+{
+    auto last_name = [](const person &p) { return p.last_name_; };
+    auto name_and_salary = [](const person &p) { return std::make_pair(p.last_name_, p.salary_); };
+}
+
+// extract into the container of the given as<Collection> operation
+template<typename CT, typename ET>
+static void conversionLinqcpp(benchmark::State &state, CT collection, ET extraction)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        extract{ET(extraction)},
+                        from{data},
+                        CT(collection)
+                    );
+
+        benchmark::DoNotOptimize(result);
+    }
+
+    setRowsProcessed(state);
+}
+
+// extract keys, in ascending order when sorted, into a map
+static void orderedMapLinqcpp(benchmark::State &state, bool sorted)
+{
+    std::vector<int64_t> keys(state.range(0));
+    for(size_t i = 0; i < keys.size(); ++i)
+        keys[i] = sorted ? static_cast<int64_t>(i) : static_cast<int64_t>((i * 2654435761u) % keys.size());
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        extract{[](int64_t key) { return std::make_pair(key, key); }},
+                        from{keys},
+                        asMap{}
+                    );
+
+        benchmark::DoNotOptimize(result);
+    }
+
+    setRowsProcessed(state);
+}
+
+// insert each extracted value into the container RT
+template<typename RT, typename ET>
+static void conversionLoop(benchmark::State &state, RT, ET extraction)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        RT result;
+        for(const auto &p : data)
+            result.insert(result.end(), extraction(p));
+
+        benchmark::DoNotOptimize(result);
+    }
+
+    setRowsProcessed(state);
+}
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asVector, asVector{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, vector, std::vector<std::string>{}, last_name)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asDeque, asDeque{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, deque, std::deque<std::string>{}, last_name)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asList, asList{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, list, std::list<std::string>{}, last_name)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asSet, asSet{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, set, std::set<std::string>{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLinqcpp, asFlatSet, asFlatSet{}, last_name)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asUnorderedSet, asUnorderedSet{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, unordered_set, std::unordered_set<std::string>{}, last_name)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLinqcpp, asFlatHashSet, asFlatHashSet{}, last_name)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asMap, asMap{}, name_and_salary)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, map, std::map<std::string, double>{}, name_and_salary)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLinqcpp, asFlatMap, asFlatMap{}, name_and_salary)->Apply(benchSizes);
+BENCHMARK_CAPTURE(orderedMapLinqcpp, sortedKeys, true)->Apply(benchSizes);
+BENCHMARK_CAPTURE(orderedMapLinqcpp, unsortedKeys, false)->Apply(benchSizes);
+
+BENCHMARK_CAPTURE(conversionLinqcpp, asUnorderedMap, asUnorderedMap{}, name_and_salary)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLoop, unordered_map, std::unordered_map<std::string, double>{}, name_and_salary)->Apply(benchSizes);
+BENCHMARK_CAPTURE(conversionLinqcpp, asFlatHashMap, asFlatHashMap{}, name_and_salary)->Apply(benchSizes);
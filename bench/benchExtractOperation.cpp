@@ -0,0 +1,83 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void extractLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        extract{[](const person &p) { return p.salary_; }},
+                        from{data}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(extractLinqcpp)->Apply(benchSizes);
+
+static void extractLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<double> result;
+        result.reserve(data.size());
+        for(const auto &p : data)
+            result.push_back(p.salary_);
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(extractLoop)->Apply(benchSizes);
+
+static void extractWithWhereLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                        from{data},
+                        where{[](const person &p) { return p.age_ > 30 && p.salary_ > 30000.0; }}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(extractWithWhereLinqcpp)->Apply(benchSizes);
+
+static void extractWithWhereLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<std::pair<std::string, double>> result;
+        for(const auto &p : data)
+        {
+            if(p.age_ > 30 && p.salary_ > 30000.0)
+                result.emplace_back(p.last_name_, p.salary_);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(extractWithWhereLoop)->Apply(benchSizes);
@@ -0,0 +1,112 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void orderByLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        orderBy{}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByLinqcpp)->Apply(benchSizes);
+
+static void orderByLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = data;
+        std::sort(result.begin(), result.end());
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByLoop)->Apply(benchSizes);
+
+static void orderByPredicateLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; }}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByPredicateLinqcpp)->Apply(benchSizes);
+
+static void orderByPredicateLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = data;
+        std::sort(result.begin(), result.end(),
+                  [](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; });
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByPredicateLoop)->Apply(benchSizes);
+
+static void orderByKeyLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        orderByKey{[](const person &p) { return p.salary_; }}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByKeyLinqcpp)->Apply(benchSizes);
+
+static void orderByKeyLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = data;
+        std::stable_sort(result.begin(), result.end(),
+                         [](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; });
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(orderByKeyLoop)->Apply(benchSizes);
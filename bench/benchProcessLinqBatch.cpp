@@ -0,0 +1,62 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void separateQueriesLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto young = processLinq(
+                        from{data},
+                        where{[](const person &p) { return p.age_ < 25; }}
+                    );
+        auto names = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{data},
+                        where{[](const person &p) { return p.salary_ > 90000; }}
+                    );
+        auto ages = processLinq(
+                        extract{[](const person &p) { return p.age_; }},
+                        from{data},
+                        where{[](const person &p) { return p.age_ > 60; }}
+                    );
+
+        benchmark::DoNotOptimize(young.data());
+        benchmark::DoNotOptimize(names.data());
+        benchmark::DoNotOptimize(ages.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(separateQueriesLinqcpp)->Apply(benchSizes);
+
+static void batchQueriesLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto [young, names, ages] = processLinqBatch(
+                        data,
+                        query{where{[](const person &p) { return p.age_ < 25; }}},
+                        query{extract{[](const person &p) { return p.last_name_; }},
+                              where{[](const person &p) { return p.salary_ > 90000; }}},
+                        query{extract{[](const person &p) { return p.age_; }},
+                              where{[](const person &p) { return p.age_ > 60; }}}
+                    );
+
+        benchmark::DoNotOptimize(young.data());
+        benchmark::DoNotOptimize(names.data());
+        benchmark::DoNotOptimize(ages.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(batchQueriesLinqcpp)->Apply(benchSizes);
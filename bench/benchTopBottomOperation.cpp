@@ -0,0 +1,163 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void topLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        where{[](const person &p) { return p.age_ < 30; }},
+                        top{100}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(topLinqcpp)->Apply(benchSizes);
+
+static void topLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<person> result;
+        for(const auto &p : data)
+        {
+            if(result.size() == 100)
+                break;
+
+            if(p.age_ < 30)
+                result.push_back(p);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(topLoop)->Apply(benchSizes);
+
+static void bottomLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        where{[](const person &p) { return p.age_ < 30; }},
+                        bottom{100}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(bottomLinqcpp)->Apply(benchSizes);
+
+static void bottomLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<person> result;
+        for(auto itr = data.rbegin(); itr != data.rend() && result.size() < 100; ++itr)
+        {
+            if(itr->age_ < 30)
+                result.push_back(*itr);
+        }
+        std::reverse(result.begin(), result.end());
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(bottomLoop)->Apply(benchSizes);
+
+static void pageSkipTakeLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; }},
+                        skip{data.size() / 2},
+                        take{50}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(pageSkipTakeLinqcpp)->Apply(benchSizes);
+
+static void pageSortLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto sorted = data;
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; });
+
+        auto first = sorted.begin() + std::min(sorted.size(), data.size() / 2);
+        auto last = first + std::min<size_t>(50, sorted.end() - first);
+        std::vector<person> result(first, last);
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(pageSortLoop)->Apply(benchSizes);
+
+// a small query on a small source held in place, the results of up to 8
+// values need no heap storage with asSmallVector
+template<typename CT>
+static void smallResultLinqcpp(benchmark::State &state, CT collection)
+{
+    smallVector<uint32_t, 64> ages;
+    for(const auto &p : benchData(1000))
+    {
+        if(ages.size() == ages.inline_capacity_)
+            break;
+
+        ages.push_back(p.age_);
+    }
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        extract{[](uint32_t age) { return age; }},
+                        from{ages},
+                        where{[](uint32_t age) { return age < 30; }},
+                        top{5},
+                        CT(collection)
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * ages.size());
+}
+BENCHMARK_CAPTURE(smallResultLinqcpp, asVector, asVector{});
+BENCHMARK_CAPTURE(smallResultLinqcpp, asSmallVector, asSmallVector<8>{});
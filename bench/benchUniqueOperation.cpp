@@ -0,0 +1,83 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+#include <unordered_set>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void stableUniqueLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        stableUnique{}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(stableUniqueLinqcpp)->Apply(benchSizes);
+
+static void stableUniqueLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::unordered_set<person> seen;
+        std::vector<person> result;
+        for(const auto &p : data)
+        {
+            if(seen.insert(p).second)
+                result.push_back(p);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(stableUniqueLoop)->Apply(benchSizes);
+
+static void preSortUniqueLinqcpp(benchmark::State &state)
+{
+    const auto &data = sortedBenchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        preSortUnique{}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(preSortUniqueLinqcpp)->Apply(benchSizes);
+
+static void preSortUniqueLoop(benchmark::State &state)
+{
+    const auto &data = sortedBenchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<person> result;
+        std::unique_copy(data.begin(), data.end(), std::back_inserter(result));
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(preSortUniqueLoop)->Apply(benchSizes);
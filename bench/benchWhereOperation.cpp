@@ -0,0 +1,85 @@
+#include "linqcppBenchData.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_bench;
+using namespace linqcpp;
+
+static void whereLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        where{[](const person &p) { return p.age_ < 30; }}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(whereLinqcpp)->Apply(benchSizes);
+
+static void whereLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<person> result;
+        for(const auto &p : data)
+        {
+            if(p.age_ < 30)
+                result.push_back(p);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(whereLoop)->Apply(benchSizes);
+
+static void whereMultipleLinqcpp(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto result = processLinq(
+                        from{data},
+                        where{[](const person &p) { return p.age_ > 30; }},
+                        where{[](const person &p) { return p.salary_ > 50000.0; }}
+                    );
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(whereMultipleLinqcpp)->Apply(benchSizes);
+
+static void whereMultipleLoop(benchmark::State &state)
+{
+    const auto &data = benchData(state.range(0));
+
+    for(auto _ : state)
+    {
+        std::vector<person> result;
+        for(const auto &p : data)
+        {
+            if(p.age_ > 30 && p.salary_ > 50000.0)
+                result.push_back(p);
+        }
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    setRowsProcessed(state);
+}
+BENCHMARK(whereMultipleLoop)->Apply(benchSizes);
@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Compile time benchmark, generates a translation unit of many linqcpp queries
+# and reports the time and the peak memory of compiling it.
+#
+# usage: compileTime.sh [queries] [linqcpp include directory] [wheres]
+#   queries     number of generated queries, 200 by default
+#   directory   directory of linqcpp.h, ../src by default, give the src
+#               directory of another checkout to compare with it
+#   wheres      most where operations in a query, 3 by default, longer
+#               pipelines show how the compile time grows with their length
+# CXX sets the compiler, c++ by default.
+
+set -e
+
+queries=${1:-200}
+script_dir=$(cd "$(dirname "$0")" && pwd)
+include_dir=${2:-${script_dir}/../src}
+wheres=${3:-3}
+compiler=${CXX:-c++}
+
+work_dir=$(mktemp -d)
+trap 'rm -rf "${work_dir}"' EXIT
+
+source_file=${work_dir}/queries.cpp
+
+{
+    echo '#include <linqcpp.h>'
+    echo '#include <string>'
+    echo '#include <vector>'
+    echo
+    echo 'using namespace linqcpp;'
+    echo
+    echo 'struct person { std::string first_name_; std::string last_name_; unsigned int age_; double salary_; };'
+    echo
+    echo 'size_t runQueries(const std::vector<person> &data)'
+    echo '{'
+    echo '    size_t total = 0;'
+
+    for ((query = 0; query < queries; ++query))
+    do
+        # pipelines of 3 to wheres + 6 operations
+        echo "    total += processLinq("
+        echo "        extract{[](const person &p) { return p.salary_ + ${query}; }},"
+        echo "        from{data},"
+        for ((stage = 0; stage < query % (wheres + 1); ++stage))
+        do
+            echo "        where{[](const person &p) { return p.age_ != ${query}u + ${stage}u; }},"
+        done
+        if ((query % 2 == 0))
+        then
+            echo "        orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ + ${query} < rhs.age_; }},"
+        fi
+        if ((query % 3 == 0))
+        then
+            echo "        top{${query} + 1},"
+        fi
+        if ((query % 3 == 1))
+        then
+            echo "        bottom{${query} + 1},"
+        fi
+        echo "        asVector{}"
+        echo "    ).size();"
+    done
+
+    echo '    return total;'
+    echo '}'
+} > "${source_file}"
+
+echo "compiling ${queries} queries with ${compiler} against ${include_dir}"
+
+compile=("${compiler}" -std=c++17 -O0 -I"${include_dir}" -c "${source_file}" -o "${work_dir}/queries.o")
+
+# GNU time reports the peak memory, otherwise only the time is reported
+if [ -x /usr/bin/time ]
+then
+    /usr/bin/time -f "compile time %e s, peak memory %M KB" "${compile[@]}"
+else
+    TIMEFORMAT="compile time %R s"
+    time "${compile[@]}"
+fi
@@ -0,0 +1,187 @@
+#ifndef __LINQCPP_BENCH_DATA_H__
+#define __LINQCPP_BENCH_DATA_H__
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace linqcpp_bench
+{
+
+// benchmark data, the same fields as the test person
+struct person
+{
+    std::string first_name_;
+    std::string last_name_;
+    unsigned int age_;
+    double salary_;
+
+    friend bool operator < (const person &lhs, const person &rhs)
+    {
+        if(lhs.last_name_ != rhs.last_name_)
+            return lhs.last_name_ < rhs.last_name_;
+
+        if(lhs.first_name_ != rhs.first_name_)
+            return lhs.first_name_ < rhs.first_name_;
+
+        if(lhs.age_ != rhs.age_)
+            return lhs.age_ < rhs.age_;
+
+        return lhs.salary_ < rhs.salary_;
+    }
+
+    friend bool operator == (const person &lhs, const person &rhs)
+    {
+        return lhs.first_name_ == rhs.first_name_ && lhs.last_name_ == rhs.last_name_ &&
+               lhs.age_ == rhs.age_ && lhs.salary_ == rhs.salary_;
+    }
+};
+
+// deterministic generator of person data, the same seed gives the same data
+// on every platform. Names are drawn from fixed pools so the data has
+// duplicate names, ages are 18 to 79 and salaries multiples of 500 from
+// 10000 to 89500.
+class personGenerator
+{
+public:
+    explicit personGenerator(uint64_t seed)
+        :state_(seed)
+    { }
+
+    person next()
+    {
+        static const std::vector<std::string> first_names = namePool(
+                    {"John", "Ned", "Daenerys", "Tyrion", "Sandor", "Joffrey", "Petyr", "Khal",
+                     "Ramsay", "Theon", "Jorah", "Margaery", "Samwell", "Jagen", "Podrick", "Davos"}, 4);
+        static const std::vector<std::string> last_names = namePool(
+                    {"Snow", "Stark", "Targaryen", "Lannister", "Clegane", "Baratheon", "Baelish", "Drogo",
+                     "Bolton", "Greyjoy", "Mormont", "Tyrell", "Tarly", "H'ghar", "Payne", "Seaworth"}, 16);
+
+        auto value = nextValue();
+
+        return {first_names[value % first_names.size()],
+                last_names[(value >> 8) % last_names.size()],
+                static_cast<unsigned int>(18 + (value >> 16) % 62),
+                10000.0 + 500.0 * static_cast<double>((value >> 24) % 160)};
+    }
+
+    std::vector<person> generate(size_t count)
+    {
+        std::vector<person> data;
+        data.reserve(count);
+        for(size_t i = 0; i < count; ++i)
+            data.push_back(next());
+
+        return data;
+    }
+
+private:
+    // splitmix64
+    uint64_t nextValue()
+    {
+        uint64_t value = (state_ += 0x9e3779b97f4a7c15ULL);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    // each base name with numbered variants, variants copies of each name
+    static std::vector<std::string> namePool(std::vector<std::string> names, size_t variants)
+    {
+        std::vector<std::string> pool;
+        for(const auto &name : names)
+        {
+            pool.push_back(name);
+            for(size_t variant = 1; variant < variants; ++variant)
+                pool.push_back(name + std::to_string(variant));
+        }
+
+        return pool;
+    }
+
+    uint64_t state_;
+};
+
+// environment setting, or the default if not set
+inline uint64_t environmentValue(const char *name, uint64_t default_value)
+{
+    const char *value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : default_value;
+}
+
+// the benchmark data for a number of rows, generated once with the seed
+// LINQCPP_BENCH_SEED (42 by default). Only the most recent size is kept.
+inline const std::vector<person> &benchData(size_t rows)
+{
+    static size_t cached_rows = 0;
+    static std::vector<person> data;
+
+    if(cached_rows != rows)
+    {
+        data.clear();
+        data.shrink_to_fit();
+        data = personGenerator{environmentValue("LINQCPP_BENCH_SEED", 42)}.generate(rows);
+        cached_rows = rows;
+    }
+
+    return data;
+}
+
+// the benchmark data sorted by operator<, for the pre sorted operations
+inline const std::vector<person> &sortedBenchData(size_t rows)
+{
+    static size_t cached_rows = 0;
+    static std::vector<person> data;
+
+    if(cached_rows != rows)
+    {
+        data = benchData(rows);
+        std::sort(data.begin(), data.end());
+        cached_rows = rows;
+    }
+
+    return data;
+}
+
+// benchmark sizes, 1K rows growing by 10 to LINQCPP_BENCH_MAX_ROWS (1M by
+// default, at most 100M). A 100M row run needs about 10GB of memory.
+inline void benchSizes(benchmark::internal::Benchmark *bench)
+{
+    auto max_rows = std::min<uint64_t>(environmentValue("LINQCPP_BENCH_MAX_ROWS", 1000000), 100000000);
+
+    for(uint64_t rows = 1000; rows <= max_rows; rows *= 10)
+        bench->Arg(static_cast<int64_t>(rows));
+
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+// rows processed by the benchmark, reported as items per second
+inline void setRowsProcessed(benchmark::State &state)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+}
+
+namespace std
+{
+    template<>
+    struct hash<linqcpp_bench::person>
+    {
+        size_t operator()(const linqcpp_bench::person &p) const
+        {
+            auto seed = std::hash<std::string>{}(p.last_name_);
+            seed ^= std::hash<std::string>{}(p.first_name_) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= std::hash<unsigned int>{}(p.age_) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= std::hash<double>{}(p.salary_) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+}
+
+#endif
@@ -5,11 +5,40 @@
 #include <algorithm>
 #include <vector>
 #include <deque>
+#include <list>
+#include <map>
+#include <set>
 #include <tuple>
+#include <array>
+#include <iterator>
+#include <optional>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
 #include <exception>
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
 #include <experimental/type_traits>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace linqcpp
 {
     // compile time names of the linq processes
@@ -22,6 +51,15 @@ namespace linqcpp
     static constexpr auto stable_unique_name = []() { return std::string_view{"stable_unique"}; };
     static constexpr auto top_name = []() { return std::string_view{"top"}; };
     static constexpr auto bottom_name = []() { return std::string_view{"bottom"}; };
+    static constexpr auto aggregate_name = []() { return std::string_view{"aggregate"}; };
+    static constexpr auto window_name = []() { return std::string_view{"window"}; };
+    static constexpr auto time_window_name = []() { return std::string_view{"time_window"}; };
+    static constexpr auto profile_name = []() { return std::string_view{"profile"}; };
+    static constexpr auto optimize_name = []() { return std::string_view{"optimize"}; };
+    static constexpr auto skip_name = []() { return std::string_view{"skip"}; };
+    static constexpr auto take_name = []() { return std::string_view{"take"}; };
+    static constexpr auto cancellation_name = []() { return std::string_view{"cancellation"}; };
+    static constexpr auto memory_budget_name = []() { return std::string_view{"memory_budget"}; };
 
     // compile time value to indicate when searched for process is not found
     static constexpr auto default_indicator_name = []() { return std::string_view{"default_indicator"}; };
@@ -30,10 +68,15 @@ namespace linqcpp
     static constexpr auto as_vector = []() { return std::string_view{"as_vector"}; };
     static constexpr auto as_deque = []() { return std::string_view{"as_deque"}; };
     static constexpr auto as_list = []() { return std::string_view{"as_list"}; };
+    static constexpr auto as_small_vector = []() { return std::string_view{"as_small_vector"}; };
     static constexpr auto as_set = []() { return std::string_view{"as_set"}; };
     static constexpr auto as_map = []() { return std::string_view{"as_map"}; };
     static constexpr auto as_unordered_set = []() { return std::string_view{"as_unordered_set"}; };
     static constexpr auto as_unordered_map = []() { return std::string_view{"as_unordered_map"}; };
+    static constexpr auto as_flat_set = []() { return std::string_view{"as_flat_set"}; };
+    static constexpr auto as_flat_map = []() { return std::string_view{"as_flat_map"}; };
+    static constexpr auto as_flat_hash_set = []() { return std::string_view{"as_flat_hash_set"}; };
+    static constexpr auto as_flat_hash_map = []() { return std::string_view{"as_flat_hash_map"}; };
 
     // compile time check for the default predicate
     template<typename T>
@@ -51,6 +94,72 @@ namespace linqcpp
     template<typename T, typename V>
     using contains_insert = decltype(std::declval<T>().insert(std::declval<V>()));
 
+    // compile time check for container reserve
+    template<typename T>
+    using contains_reserve = decltype(std::declval<T>().reserve(std::declval<typename T::size_type>()));
+
+    // compile time check for a node based sequence that can relink its nodes
+    template<typename T>
+    using contains_splice = decltype(std::declval<T&>().splice(std::declval<typename T::const_iterator>(),
+                                                               std::declval<T&>()));
+
+    // compile time check for container bucket_count (unordered containers)
+    template<typename T>
+    using contains_bucket_count = decltype(std::declval<T>().bucket_count());
+
+    // compile time check for a std::hash specialisation
+    template<typename T>
+    using contains_hash = decltype(std::hash<T>{}(std::declval<const T&>()));
+
+    // compile time check for operator<
+    template<typename T>
+    using contains_less = decltype(std::declval<const T&>() < std::declval<const T&>());
+
+    // compile time check for a flat container held in a sorted vector
+    template<typename T>
+    using flat_storage_type = typename T::storage_type;
+
+    // compile time check for an open addressed flat hash container
+    template<typename T>
+    using flat_hash_type = typename T::control_type;
+
+    // compile time check for a container holding its first elements in place
+    template<typename T>
+    using small_buffer_type = decltype(T::inline_capacity_);
+
+    // compile time check for an ordered associative container
+    template<typename T>
+    using contains_key_compare = typename T::key_compare;
+
+    // compile time check for an element reporting the heap bytes it owns
+    template<typename T>
+    using contains_owned_bytes = decltype(std::declval<const T&>().ownedBytes());
+
+    // compile time check for a pair of values
+    template<typename T>
+    using pair_first_type = decltype(std::declval<const T&>().first);
+
+    // compile time check for a container or string holding its elements
+    template<typename T>
+    using contains_elements = decltype(std::declval<const T&>().begin(), std::declval<typename T::value_type>());
+
+    // compile time check for contiguous storage
+    template<typename T>
+    using contains_data = decltype(std::declval<const T&>().data());
+
+    // compile time check for an associative container mapping keys to values
+    template<typename T>
+    using contains_mapped_type = typename T::mapped_type;
+
+    // compile time check for an associative container with unique keys, its
+    // insert reports whether the value was inserted
+    template<typename T>
+    using unique_insert_type = decltype(std::declval<T&>().insert(std::declval<typename T::value_type>()).second);
+
+    // compile time check for a where predicate that an index can answer
+    template<typename T>
+    using index_lookup_type = decltype(std::declval<const T&>().lookup());
+
     // compile time indicator that a searched for process does not exist
     struct defaultIndicator
     {
@@ -78,7 +187,7 @@ namespace linqcpp
         // used by the extract process to get a requested vector type to store
         // results
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, [[maybe_unused]] const TArgs& ...args) const
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
         {
             return std::vector<ST>{};
         }
@@ -94,8 +203,12 @@ namespace linqcpp
             // if no extract operation defined return the given data unchanged
             if constexpr(extract_op.operation!=default_indicator_name())
                 return std::move(data);
-            else // copy data into vector and return vector
-                return std::vector<typename DT::value_type>{data.begin(), data.end()};
+            // the data is already a vector, return it as it is
+            else if constexpr(std::is_same_v<std::decay_t<DT>, std::vector<typename DT::value_type>>)
+                return std::move(data);
+            else // move data into vector and return vector
+                return std::vector<typename DT::value_type>(std::make_move_iterator(data.begin()),
+                                                            std::make_move_iterator(data.end()));
         }
     };
 
@@ -116,27 +229,71 @@ namespace linqcpp
             return defaultIndicator{};
     }
 
+    // compile time index of the first operation with the given name in the
+    // operation types, the number of types if there is none. Evaluated in a
+    // single expansion of the types rather than a recursion over them.
+    template<typename ...TArgs, typename NT>
+    constexpr size_t operationIndex([[maybe_unused]] NT name)
+    {
+        constexpr size_t count = sizeof...(TArgs);
+        const bool matches[count + 1] = {(TArgs::operation == name())..., true};
+
+        size_t index = 0;
+        while(!matches[index])
+            ++index;
+
+        return index;
+    }
+
+    // the operation at the given index of the operations list, selected
+    // without a recursion over the list
+    template<size_t I, typename ...TArgs>
+    const auto &operationAt(const TArgs& ...args)
+    {
+        using operation_type = std::tuple_element_t<I, std::tuple<TArgs...>>;
+
+        const void *operations[] = {std::addressof(args)...};
+        return *static_cast<const operation_type*>(operations[I]);
+    }
+
     // compile time search for given name operation in the operations list. 
-    template<typename NT, typename FT, typename ...TArgs>
-    auto findOperation(NT name, const FT &first, const TArgs& ...args)
+    template<typename NT, typename ...TArgs>
+    auto findOperation(NT name, const TArgs& ...args)
     {   
-        if constexpr (name()==FT::operation)
-        {
-            return first; // return the operation if list head is operation searched for
-        }
+        constexpr auto index = operationIndex<TArgs...>(name);
+
+        if constexpr (index < sizeof...(TArgs))
+            return operationAt<index>(args...); // return the operation found
         else
+            return findOperation(name); // not found, the terminator gives the default
+    }
+
+    // the operation types of an operations tuple
+    template<typename TT>
+    struct tupleOperations;
+
+    template<typename ...TArgs>
+    struct tupleOperations<std::tuple<TArgs...>>
+    {
+        static constexpr std::array<std::string_view, sizeof...(TArgs)> names_ = {TArgs::operation...};
+
+        template<typename NT>
+        static constexpr size_t index(NT name)
         {
-            return findOperation(name, args...); // continue search with next operation in list
+            return operationIndex<TArgs...>(name);
         }
-    }
+    };
 
     // search for given named operation from tuple 
     template<typename NT, typename TT, size_t... Is>
     auto findOperationFromTuple(NT name, const TT &tuple_pack, std::index_sequence<Is...>)
     {
-        // expand the tuple into a parameter pack and use above find operation
-        // to do the work
-        return findOperation(name, std::get<Is>(tuple_pack)...);
+        constexpr auto index = tupleOperations<TT>::index(name);
+
+        if constexpr (index < sizeof...(Is))
+            return std::get<index>(tuple_pack);
+        else
+            return findOperation(name);
     }
 
     // linqcpp result as a deque
@@ -148,7 +305,7 @@ namespace linqcpp
         // used by the extract process to get a requested deque type to store
         // results
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, [[maybe_unused]] const TArgs& ...args) const
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
         {
             return std::deque<ST>{};
         }
@@ -165,11 +322,392 @@ namespace linqcpp
             // extract operation will request the deque for the extract result
             if constexpr(extract_op.operation!=default_indicator_name())
                 return std::move(data);
-            else // copy data into and return a deque
-                return std::deque<typename DT::value_type>{data.begin(), data.end()};
+            // the data is already a deque, return it as it is
+            else if constexpr(std::is_same_v<std::decay_t<DT>, std::deque<typename DT::value_type>>)
+                return std::move(data);
+            else // move data into and return a deque
+                return std::deque<typename DT::value_type>(std::make_move_iterator(data.begin()),
+                                                           std::make_move_iterator(data.end()));
+        }
+    };
+
+    // a vector holding up to N elements in place, inside the object itself,
+    // the elements are moved to the heap only when more than N are held.
+    // Iterators are pointers, as with std::vector they are invalidated when
+    // the capacity grows.
+    template<typename T, size_t N>
+    class smallVector
+    {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_t inline_capacity_ = N;
+
+        smallVector() = default;
+
+        smallVector(std::initializer_list<T> values)
+            :smallVector(values.begin(), values.end())
+        { }
+
+        template<typename IT, typename = typename std::iterator_traits<IT>::iterator_category>
+        smallVector(IT first, IT last)
+        {
+            using iterator_category = typename std::iterator_traits<IT>::iterator_category;
+            if constexpr(std::is_base_of_v<std::forward_iterator_tag, iterator_category>)
+                reserve(std::distance(first, last));
+
+            for(; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        smallVector(const smallVector &other)
+        {
+            reserve(other.size_);
+            std::uninitialized_copy(other.begin(), other.end(), data_);
+            size_ = other.size_;
+        }
+
+        // heap elements are taken over, elements held in place are moved
+        smallVector(smallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            moveFrom(other);
+        }
+
+        smallVector &operator=(const smallVector &other)
+        {
+            if(this != &other)
+            {
+                clear();
+                reserve(other.size_);
+                std::uninitialized_copy(other.begin(), other.end(), data_);
+                size_ = other.size_;
+            }
+
+            return *this;
+        }
+
+        smallVector &operator=(smallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if(this != &other)
+            {
+                clear();
+                releaseHeap();
+                moveFrom(other);
+            }
+
+            return *this;
+        }
+
+        ~smallVector()
+        {
+            clear();
+            releaseHeap();
+        }
+
+        iterator begin() { return data_; }
+        iterator end() { return data_ + size_; }
+        const_iterator begin() const { return data_; }
+        const_iterator end() const { return data_ + size_; }
+        const_iterator cbegin() const { return data_; }
+        const_iterator cend() const { return data_ + size_; }
+        reverse_iterator rbegin() { return reverse_iterator{end()}; }
+        reverse_iterator rend() { return reverse_iterator{begin()}; }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+        const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+        size_type size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        size_type capacity() const { return capacity_; }
+
+        // true while the elements are held in place
+        bool isInline() const { return data_ == inlineData(); }
+
+        T *data() { return data_; }
+        const T *data() const { return data_; }
+
+        reference operator[](size_type position) { return data_[position]; }
+        const_reference operator[](size_type position) const { return data_[position]; }
+        reference front() { return data_[0]; }
+        const_reference front() const { return data_[0]; }
+        reference back() { return data_[size_ - 1]; }
+        const_reference back() const { return data_[size_ - 1]; }
+
+        void reserve(size_type required)
+        {
+            if(required > capacity_)
+            {
+                T *heap = std::allocator<T>{}.allocate(required);
+                relocate(heap, required);
+            }
+        }
+
+        void push_back(const T &value) { emplace_back(value); }
+        void push_back(T &&value) { emplace_back(std::move(value)); }
+
+        template<typename ...Args>
+        reference emplace_back(Args&& ...args)
+        {
+            if(size_ < capacity_)
+            {
+                ::new(static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+            }
+            else
+            {
+                // the new element is made before the elements are moved, the
+                // arguments can refer to one of them
+                auto required = std::max<size_type>(capacity_ * 2, 1);
+                T *heap = std::allocator<T>{}.allocate(required);
+                try
+                {
+                    ::new(static_cast<void*>(heap + size_)) T(std::forward<Args>(args)...);
+                }
+                catch(...)
+                {
+                    std::allocator<T>{}.deallocate(heap, required);
+                    throw;
+                }
+
+                relocate(heap, required);
+            }
+
+            return data_[size_++];
+        }
+
+        void pop_back()
+        {
+            data_[--size_].~T();
+        }
+
+        iterator erase(const_iterator position)
+        {
+            return erase(position, position + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            auto erase_first = begin() + (first - begin());
+            auto erase_last = begin() + (last - begin());
+
+            auto new_end = std::move(erase_last, end(), erase_first);
+            std::destroy(new_end, end());
+            size_ = new_end - begin();
+
+            return erase_first;
+        }
+
+        // the elements are destroyed, any heap storage is kept
+        void clear()
+        {
+            std::destroy(begin(), end());
+            size_ = 0;
+        }
+
+        bool operator==(const smallVector &other) const
+        {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+
+        bool operator!=(const smallVector &other) const { return !(*this == other); }
+
+    private:
+        T *inlineData() { return reinterpret_cast<T*>(inline_); }
+        const T *inlineData() const { return reinterpret_cast<const T*>(inline_); }
+
+        // move the elements into the heap storage, which becomes the storage
+        void relocate(T *heap, size_type heap_capacity)
+        {
+            std::uninitialized_move(begin(), end(), heap);
+            std::destroy(begin(), end());
+            releaseHeap();
+
+            data_ = heap;
+            capacity_ = heap_capacity;
+        }
+
+        void releaseHeap()
+        {
+            if(!isInline())
+                std::allocator<T>{}.deallocate(data_, capacity_);
+
+            data_ = inlineData();
+            capacity_ = N;
+        }
+
+        // only called when empty and in place
+        void moveFrom(smallVector &other)
+        {
+            if(!other.isInline())
+            {
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                size_ = other.size_;
+
+                other.data_ = other.inlineData();
+                other.capacity_ = N;
+                other.size_ = 0;
+            }
+            else
+            {
+                std::uninitialized_move(other.begin(), other.end(), data_);
+                size_ = other.size_;
+                other.clear();
+            }
+        }
+
+        alignas(T) unsigned char inline_[sizeof(T) * (N > 0 ? N : 1)];
+        T *data_ = inlineData();
+        size_type size_ = 0;
+        size_type capacity_ = N;
+    };
+
+    // linqcpp result as a smallVector holding up to N elements in place, so
+    // a result of up to N elements needs no heap storage
+    template<size_t N>
+    struct asSmallVector
+    {
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_small_vector();
+
+        // used by the extract process to get a requested smallVector type to
+        // store results
+        template<typename ST, typename ...TArgs>
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
+        {
+            return smallVector<ST, N>{};
+        }
+
+        // used by process list processing to convert current collection to
+        // smallVector if no extract operation defined
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                      std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            using value_type = typename std::decay_t<DT>::value_type;
+
+            // if there is an extract operation then just return the data as the
+            // extract operation will request the smallVector for the result
+            if constexpr(extract_op.operation!=default_indicator_name())
+                return std::move(data);
+            // the data is already the smallVector, return it as it is
+            else if constexpr(std::is_same_v<std::decay_t<DT>, smallVector<value_type, N>>)
+                return std::move(data);
+            else // move data into and return a smallVector
+                return smallVector<value_type, N>(std::make_move_iterator(data.begin()),
+                                                  std::make_move_iterator(data.end()));
+        }
+    };
+
+    // linqcpp result as a list
+    struct asList
+    {
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_list();
+
+        // used by the extract process to get a requested list type to store
+        // results
+        template<typename ST, typename ...TArgs>
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
+        {
+            return std::list<ST>{};
+        }
+
+        // used by process list processing to convert current collection to
+        // list if no extract operation defined
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                      std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            // if there is an extract operation then just return the data as the
+            // extract operation will request the list for the extract result
+            if constexpr(extract_op.operation!=default_indicator_name())
+                return std::move(data);
+            // the data is already a list, its nodes are returned as they are
+            else if constexpr(std::is_same_v<std::decay_t<DT>, std::list<typename DT::value_type>>)
+                return std::move(data);
+            else // move data into and return a list
+                return std::list<typename DT::value_type>(std::make_move_iterator(data.begin()),
+                                                          std::make_move_iterator(data.end()));
         }
     };
 
+    // if results ordered by the orderBy operation use operator<, there is no
+    // orderBy or it has no predicate
+    template<typename OT>
+    constexpr bool defaultOrdering()
+    {
+        if constexpr(OT::operation == default_indicator_name())
+            return true;
+        else
+            return std::experimental::is_detected<pred_type, decltype(std::declval<const OT&>().order_by_operation_)>::value;
+    }
+
+    // insert values into an ordered tree container in key order, each value
+    // is inserted at the end of the tree without a search so values already
+    // in order are built in linear time. Values out of order are sorted first,
+    // stably so the first of equal keys is the one kept, as by insert, for
+    // unique keys, and equal keys keep their order in a multiset or multimap.
+    // values - random access range of the values, moved from
+    template<typename RT, typename ST>
+    void sortedInsert(RT &results, ST &values)
+    {
+        auto key_less = [compare = results.key_comp()](const auto &lhs, const auto &rhs) {
+            if constexpr(std::experimental::is_detected<contains_mapped_type, RT>::value)
+                return compare(lhs.first, rhs.first);
+            else
+                return compare(lhs, rhs);
+        };
+
+        if(!std::is_sorted(values.begin(), values.end(), key_less))
+            std::stable_sort(values.begin(), values.end(), key_less);
+
+        if constexpr(std::experimental::is_detected<unique_insert_type, RT>::value)
+        {
+            // equal keys are adjacent, only the first is inserted
+            std::optional<typename RT::iterator> previous;
+            for(auto &value : values)
+            {
+                if(previous && !key_less(**previous, value))
+                    continue;
+
+                previous = results.emplace_hint(results.end(), std::move(value));
+            }
+        }
+        else
+        {
+            // every value is inserted, after the equal keys before it
+            for(auto &value : values)
+                results.emplace_hint(results.end(), std::move(value));
+        }
+    }
+
+    // fill an ordered tree container with the data, data that can be ordered
+    // in place is inserted through sortedInsert
+    template<typename RT, typename DT>
+    void orderedFill(RT &results, DT &data)
+    {
+        using iterator_category = typename std::iterator_traits<typename DT::iterator>::iterator_category;
+
+        if constexpr(std::is_base_of_v<std::random_access_iterator_tag, iterator_category> &&
+                     std::is_move_assignable_v<typename DT::value_type>)
+            sortedInsert(results, data);
+        else
+            results.insert(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+    }
+
     // linqcpp result as a map
     // All the same requirements on the maps keys and values still apply
     struct asMap
@@ -180,12 +718,12 @@ namespace linqcpp
         // used by the extract process to get a requested map type to store
         // results.
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, const TArgs& ...args) const
+        auto results_collection(const TArgs& ...args) const
         {
             auto order_by_op = findOperation(order_by_name, args...);
 
-            // if there is not an order by process
-            if constexpr(order_by_op.operation == default_indicator_name())
+            // if there is not an order by process, or one with no predicate
+            if constexpr(defaultOrdering<std::decay_t<decltype(order_by_op)>>())
                 // return a std map
                 return std::map<typename ST::first_type, typename ST::second_type>{};
             else
@@ -212,18 +750,22 @@ namespace linqcpp
                 auto order_by_op = findOperationFromTuple(order_by_name, tuple_data_pack,
                                                           std::make_index_sequence<std::tuple_size<TT>{}>{});
 
-                if constexpr(order_by_op.operation == default_indicator_name())
-                    // No order by operation, copy data into map and use default
-                    // operator< from key
-                    return std::map<typename DT::first_type, typename DT::second_type>
-                        {data.begin(), data.end()};
-                else
-                    // return map copying data into map using order by operation as the comparison operator
-                    return std::map<typename DT::first_type, 
-                                    typename DT::second_type,
-                                    decltype(order_by_op.order_by_operation_)>
-                                    {data.begin(), data.end()};
+                using value_type = typename std::decay_t<DT>::value_type;
+
+                auto results = [](const auto &order_by_op) {
+                    if constexpr(defaultOrdering<std::decay_t<decltype(order_by_op)>>())
+                        // No order by operation, use default operator< from key
+                        return std::map<typename value_type::first_type, typename value_type::second_type>{};
+                    else
+                        // use the order by operation as the comparison operator
+                        return std::map<typename value_type::first_type,
+                                        typename value_type::second_type,
+                                        decltype(order_by_op.order_by_operation_)>{order_by_op.order_by_operation_};
+                }(order_by_op);
 
+                // move data into the map
+                orderedFill(results, data);
+                return results;
             }
         }
     };
@@ -237,11 +779,11 @@ namespace linqcpp
         // used by the extract process to get a requested set type to store
         // results.
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, const TArgs ...args) const
+        auto results_collection(const TArgs& ...args) const
         {
             auto order_by_op = findOperation(order_by_name, args...);
 
-            if constexpr(order_by_op.operation == default_indicator_name())
+            if constexpr(defaultOrdering<std::decay_t<decltype(order_by_op)>>())
                 // no order by process, return a std set
                 return std::set<ST>{};
             else
@@ -268,13 +810,21 @@ namespace linqcpp
                 auto order_by_op = findOperationFromTuple(order_by_name, tuple_data_pack,
                                                           std::make_index_sequence<std::tuple_size<TT>{}>{});
 
-                if constexpr(order_by_op.operation == default_indicator_name())
-                    // no order by operation, copy data into std set
-                    return std::set<DT>{data.begin(), data.end()};
-                else
-                    // return set copying data into set using order by operation as the comparison operator
-                    return std::set<DT,
-                            decltype(order_by_op.order_by_operation_)>{data.begin(), data.end()};
+                using value_type = typename std::decay_t<DT>::value_type;
+
+                auto results = [](const auto &order_by_op) {
+                    if constexpr(defaultOrdering<std::decay_t<decltype(order_by_op)>>())
+                        // no order by operation, std set
+                        return std::set<value_type>{};
+                    else
+                        // set using order by operation as the comparison operator
+                        return std::set<value_type,
+                                        decltype(order_by_op.order_by_operation_)>{order_by_op.order_by_operation_};
+                }(order_by_op);
+
+                // move data into the set
+                orderedFill(results, data);
+                return results;
             }
         }
     };
@@ -288,7 +838,7 @@ namespace linqcpp
         // used by the extract process to get a requested unordered_map type to store
         // results.
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, const TArgs ...args) const
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
         {
             return std::unordered_map<typename ST::first_type, typename ST::second_type>{};
         }
@@ -306,9 +856,11 @@ namespace linqcpp
                 return std::move(data);
             else
             {
-                // return unordered_map copying data in the map
-                return std::unordered_map<typename DT::first_type, typename DT::second_type>
-                        {data.begin(), data.end()};
+                using value_type = typename std::decay_t<DT>::value_type;
+
+                // return unordered_map moving data into the map
+                return std::unordered_map<typename value_type::first_type, typename value_type::second_type>
+                        (std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
             }
         }
     };
@@ -322,7 +874,7 @@ namespace linqcpp
         // used by the extract process to get a requested unordered_set type to store
         // results.
         template<typename ST, typename ...TArgs>
-        auto results_collection([[maybe_unused]] const ST &dummy, const TArgs ...args) const
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
         {
             return std::unordered_set<ST>{};
         }
@@ -340,425 +892,5880 @@ namespace linqcpp
                 return std::move(data);
             else
             {
-                // return unordered_set copying data in the set
-                return std::unordered_set<DT>{data.begin(), data.end()};
+                // return unordered_set moving data into the set
+                return std::unordered_set<typename std::decay_t<DT>::value_type>
+                        (std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
             }
         }
     };
 
+    // the comparison of ordered results containers, the orderBy predicate if
+    // one is given otherwise operator<
+    template<typename OT>
+    auto orderingCompare([[maybe_unused]] const OT &order_by_op)
+    {
+        if constexpr(defaultOrdering<OT>())
+            return std::less<>{};
+        else
+            return order_by_op.order_by_operation_;
+    }
 
-    // extract operation
-    // extracts the data defined in the predicate and puts the results into the
-    // defined container or std::vector if container is not defined
-    template<typename ST>
-    struct extract
+    // the key of a flatSet element, the element itself
+    struct flatSetKey
     {
-        static constexpr auto operation = extract_name();
+        template<typename VT>
+        const VT &operator()(const VT &value) const { return value; }
+    };
 
-        ST extract_operation_;
-        extract(ST &&extract_op)
-            :extract_operation_(std::move(extract_op))
+    // the key of a flatMap element, the first of the pair
+    struct flatMapKey
+    {
+        template<typename VT>
+        const auto &operator()(const VT &value) const { return value.first; }
+    };
+
+    // flatSorted
+    // the storage of the flat containers, the elements are held in a vector
+    // ordered by the comparison CT of their keys, KP gives the key of an
+    // element. Lookups are binary searches of the vector. Values are added in
+    // bulk, appended then ordered by one sort of the values added and a merge
+    // with those held, of equal keys the first added is kept.
+    template<typename VT, typename CT, typename KP>
+    class flatSorted
+    {
+    public:
+        using value_type = VT;
+        using storage_type = std::vector<VT>;
+        using size_type = typename storage_type::size_type;
+        using iterator = typename storage_type::iterator;
+        using const_iterator = typename storage_type::const_iterator;
+        using const_reverse_iterator = typename storage_type::const_reverse_iterator;
+
+        flatSorted(CT compare = CT{})
+            :compare_(std::move(compare))
         { }
 
-        // process the extraction
-        // data - container to perform the extract operation on
-        // args - compile time list from which to obtain the results container
-        //        and the from operation to help with figuring out the type of
-        //        the result.
-        template<typename DT, typename ...TArgs>
-        auto process(DT &&data, const TArgs& ...args)
+        // take the values as the storage, ordered and made unique in place
+        flatSorted(storage_type values, CT compare)
+            :values_(std::move(values)), compare_(std::move(compare))
         {
-            // find if the container for the results is defined (returned
-            // default is std::vector)
-            auto result_type = findOperation(to_collection_name, args...);
-            auto from_op = findOperation(from_name, args...);
+            restoreOrder(0);
+        }
 
-            // obtain the results container given the type of the data to be
-            // extracted
-            auto results = result_type.results_collection(extract_operation_(from_op.valueTypeValue()), args...);
+        const_iterator begin() const { return values_.begin(); }
+        const_iterator end() const { return values_.end(); }
+        const_iterator cbegin() const { return values_.cbegin(); }
+        const_iterator cend() const { return values_.cend(); }
+        const_reverse_iterator rbegin() const { return values_.rbegin(); }
+        const_reverse_iterator rend() const { return values_.rend(); }
 
-            if constexpr(std::experimental::is_detected<contains_push_back, 
-                                                        decltype(results),
-                                                        decltype(extract_operation_(from_op.valueTypeValue()))
-                                                        >::value)
-            {
-                // results container has a push_back method so use back_inserter
-                // to fill the results container
-                std::transform(data.begin(), data.end(),
-                            std::back_inserter(results), extract_operation_);
-            }
-            else if constexpr(std::experimental::is_detected<contains_insert,
-                                                             decltype(results),
-                                                             decltype(extract_operation_(from_op.valueTypeValue()))
-                                                             >::value)
-            {
-                // results container has insert method use std::inserter
-                std::transform(data.begin(), data.end(),
-                            std::inserter(results, results.end()), extract_operation_);
-            }
-            else
-            {
-                // neither push_back or insert method exists, compile time error out
-                constexpr bool error = std::experimental::is_detected<contains_push_back, 
-                                                        decltype(results),
-                                                        decltype(extract_operation_(from_op.valueTypeValue()))
-                                                        >::value
-                                       ||
-                                       std::experimental::is_detected<contains_insert,
-                                                             decltype(results),
-                                                             decltype(extract_operation_(from_op.valueTypeValue()))
-                                                             >::value;
+        size_type size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+        size_type capacity() const { return values_.capacity(); }
+        void reserve(size_type count) { values_.reserve(count); }
+        void clear() { values_.clear(); }
 
-                static_assert(error, "results container has no push_back or insert methods");
-            }
+        const CT &key_comp() const { return compare_; }
 
-            return results;
+        template<typename KT>
+        const_iterator lower_bound(const KT &key) const { return lowerBound(values_, key); }
+
+        template<typename KT>
+        const_iterator upper_bound(const KT &key) const
+        {
+            return std::upper_bound(values_.begin(), values_.end(), key,
+                                    [this](const KT &lhs, const VT &rhs) { return compare_(lhs, KP{}(rhs)); });
         }
-    };
 
-    // from operation
-    // required process for linqcpp to work, takes a copy of the data because
-    // the data can be sorted, transformed and truncated before being put into
-    // another container. So design decision is to take the data by value as a
-    // copy will be required anyway for any of those operations to be performed
-    template<typename FT>
-    struct from
-    {
-        static constexpr auto operation = from_name();
-        using value_type = typename FT::value_type;
+        template<typename KT>
+        std::pair<const_iterator, const_iterator> equal_range(const KT &key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
 
-        FT from_data;
-        from(FT from_dt)
-            :from_data(std::move(from_dt))
-        { }
+        template<typename KT>
+        const_iterator find(const KT &key) const { return findIn(values_, key); }
 
-        // The value in the data container needs to be default constructable.
-        auto valueTypeValue() { return value_type{}; }
+        template<typename KT>
+        bool contains(const KT &key) const { return find(key) != end(); }
 
-    };
+        template<typename KT>
+        size_type count(const KT &key) const { return contains(key) ? 1 : 0; }
 
-    // where operation
-    // to filter the data based on the where_operation predicate
-    template<typename WT>
-    struct where
-    {
-        static constexpr auto operation = where_name();
+        // insert a single value in order, the position of the value held and
+        // false if one with an equal key is already held
+        std::pair<iterator, bool> insert(VT value)
+        {
+            auto itr = lowerBound(values_, KP{}(value));
+            if(itr != values_.end() && !compare_(KP{}(value), KP{}(*itr)))
+                return {itr, false};
 
-        WT where_operation_;
-        where(WT &&where_op)
-            :where_operation_(std::move(where_op))
-        { }
+            return {values_.insert(itr, std::move(value)), true};
+        }
 
-        // process the where filter
-        // tuple_data_pack is unused in this operation
-        // data - the data on which to perform the filter operation
-        template<typename TT, typename DT>
-        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        template<typename IT>
+        void insert(IT first, IT last)
         {
-            DT results;
-            std::copy_if(data.begin(), data.end(), 
-                         std::back_inserter(results), where_operation_);
+            bulkInsert([first, last](auto inserter) { std::copy(first, last, inserter); });
+        }
 
-            return results;
+        // append the values fill writes to the back inserter it is given then
+        // restore the ordering
+        template<typename FT>
+        void bulkInsert(FT fill)
+        {
+            auto held = values_.size();
+            fill(std::back_inserter(values_));
+            restoreOrder(held);
         }
-    };
 
-    // orderBy operation
-    // order the data using the order_by_operation predicate or if the results
-    // container is a map or set use the predicate as the comparison predicate
-    template<typename OT = defaultIndicator>
-    struct orderBy
-    {
-        static constexpr auto operation = order_by_name();
+        bool operator==(const flatSorted &other) const { return values_ == other.values_; }
+        bool operator!=(const flatSorted &other) const { return values_ != other.values_; }
 
-        OT order_by_operation_;
-        orderBy(OT order_by_op = defaultIndicator{})
-            :order_by_operation_(std::move(order_by_op))
-        { }
+    protected:
+        storage_type values_;
+        CT compare_;
 
-        // process the ordering
-        // compile time search the tuple_data_pack for the results container to
-        // decide if the container should be sorted or if container is map or
-        // set type then do not sort here as order_by_operation predicate will
-        // be used by as the comparison predicate
-        template<typename TT, typename DT>
-        auto process(const TT &tuple_data_pack, DT &&data)
+        template<typename ST, typename KT>
+        auto lowerBound(ST &values, const KT &key) const
         {
-            auto container_op = findOperationFromTuple(to_collection_name, tuple_data_pack,
-                                                      std::make_index_sequence<std::tuple_size<TT>{}>{});
+            return std::lower_bound(values.begin(), values.end(), key,
+                                    [this](const VT &lhs, const KT &rhs) { return compare_(KP{}(lhs), rhs); });
+        }
 
-            // makes no sense to order if results container is an unordered type
-            static_assert(!(container_op.container_type == as_unordered_map() ||
-                            container_op.container_type == as_unordered_set()),
-                            "Cannot have ordered by operations for unordered containers");
+        template<typename ST, typename KT>
+        auto findIn(ST &values, const KT &key) const
+        {
+            auto itr = lowerBound(values, key);
+            if(itr != values.end() && compare_(key, KP{}(*itr)))
+                return values.end();
 
-            if constexpr(container_op.container_type != as_map() &&
-                         container_op.container_type != as_set() )
-            {
-                // if container has its own sort method ie list then use that
-                if constexpr(std::experimental::is_detected<contains_sort, DT>::value)
-                {
-                    // if sorting predicate is not supplied, use std form of sort
-                    if constexpr(std::experimental::is_detected<pred_type, OT>::value)
-                        data.sort();
-                    else
-                        data.sort(order_by_operation_); // else use the supplied predicate
-                }
-                else // container doesn't have its own sorting method
-                {
-                    if constexpr(std::experimental::is_detected<pred_type, OT>::value)
-                        std::sort(data.begin(), data.end());
-                    else
-                        std::sort(data.begin(), data.end(), order_by_operation_);
-                }
-            }
+            return itr;
+        }
 
-            return std::move(data);
+        // the values from held on were appended, sort them keeping the order
+        // they were added in, merge them with the values before and remove
+        // all but the first of equal keys
+        void restoreOrder(size_type held)
+        {
+            auto less = [this](const VT &lhs, const VT &rhs) { return compare_(KP{}(lhs), KP{}(rhs)); };
+            auto middle = std::next(values_.begin(), held);
+
+            std::stable_sort(middle, values_.end(), less);
+            std::inplace_merge(values_.begin(), middle, values_.end(), less);
+
+            // sorted, so a value not less than the one before has an equal key
+            values_.erase(std::unique(values_.begin(), values_.end(),
+                                      [&less](const VT &lhs, const VT &rhs) { return !less(lhs, rhs); }),
+                          values_.end());
         }
     };
 
-    // stable unique, remove duplicates keeping order
-    template<typename UT = defaultIndicator>
-    struct stableUnique
+    // flatSet
+    // a set held in a sorted vector, one allocation for all of the elements
+    // and lookups by binary search. Inserting a single element moves the
+    // elements after it, built for results that are filled once then
+    // searched.
+    template<typename T, typename CT = std::less<>>
+    class flatSet : public flatSorted<T, CT, flatSetKey>
     {
-        static constexpr auto operation = stable_unique_name();
+    public:
+        using key_type = T;
+        using key_compare = CT;
 
-        UT unique_predicate_;
+        // as with std::set the elements can not be changed through iterators
+        using iterator = typename flatSorted<T, CT, flatSetKey>::const_iterator;
 
-        stableUnique(UT unique_pred = defaultIndicator{})
-            :unique_predicate_(std::move(unique_pred))
-        { }
+        using flatSorted<T, CT, flatSetKey>::flatSorted;
+    };
 
-        // process the uniqueness 
-        // tuple_data_pack is unused 
-        // data - remove duplicates from this container
-        template<typename TT, typename DT>
-        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
-        {
-            // use an unordered_set to determine if value already extsts
-            auto value_set = [&](){
-                                if constexpr(std::experimental::is_detected<pred_type, UT>::value)
-                                {
-                                    return std::unordered_set<typename DT::value_type> {};
-                                }
-                                else
-                                {
-                                    // a predicate is provided to determine
-                                    // uniqueness so use that.
-                                    return std::unordered_set<typename DT::value_type,
-                                                              std::hash<typename DT::value_type>,
-                                                              decltype(unique_predicate_)> 
-                                                {1, std::hash<typename DT::value_type>{}, 
-                                                    unique_predicate_};
-                                }
-                    }();
-
-
-            auto new_end = std::remove_if(data.begin(), data.end(),
-                                            [&value_set](const typename DT::value_type &value) {
-                                                return !value_set.insert(value).second;
-                                          });
-
-            data.erase(new_end, data.end());
+    // flatMap
+    // a map held in a sorted vector of key value pairs, the keys must not be
+    // changed through the iterators
+    template<typename KT, typename MT, typename CT = std::less<>>
+    class flatMap : public flatSorted<std::pair<KT, MT>, CT, flatMapKey>
+    {
+        using base_type = flatSorted<std::pair<KT, MT>, CT, flatMapKey>;
 
-            return std::move(data);
-        }
+    public:
+        using key_type = KT;
+        using mapped_type = MT;
+        using key_compare = CT;
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
 
-    };
+        using base_type::base_type;
+        using base_type::begin;
+        using base_type::end;
+        using base_type::find;
 
-    // unique operation
-    // for data sets that are already sorted, quicker as there is no need to
-    // keep track of duplicates
-    template<typename UT = defaultIndicator>
-    struct preSortUnique
-    {
-        static constexpr auto operation = pre_sort_unique_name();
+        iterator begin() { return this->values_.begin(); }
+        iterator end() { return this->values_.end(); }
 
-        UT unique_predicate_;
+        template<typename LT>
+        iterator find(const LT &key) { return this->findIn(this->values_, key); }
 
-        preSortUnique(UT unique_pred = defaultIndicator{})
-            :unique_predicate_(std::move(unique_pred))
-        { }
+        MT &at(const KT &key)
+        {
+            auto itr = find(key);
+            if(itr == end())
+                throw std::out_of_range("linqcpp flatMap key not found");
 
-        // process the uniqueness
-        // tuple_data_pack - unused in this operation
-        // data - remove duplicates from this container
-        template<typename TT, typename DT>
-        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+            return itr->second;
+        }
+
+        const MT &at(const KT &key) const
         {
+            auto itr = find(key);
+            if(itr == end())
+                throw std::out_of_range("linqcpp flatMap key not found");
 
-            if constexpr(std::experimental::is_detected<pred_type, UT>::value)
-            {
-                auto last = std::unique(data.begin(), data.end());
-                data.erase(last, data.end());
-            }
-            else
-            {
-                // use unique predicate if provided
-                auto last = std::unique(data.begin(), data.end(), unique_predicate_);
-                data.erase(last, data.end());
-            }
+            return itr->second;
+        }
 
-            return std::move(data);
+        // the value of the key, a default value is inserted for a key not held
+        MT &operator[](const KT &key)
+        {
+            auto itr = this->lowerBound(this->values_, key);
+            if(itr == end() || this->compare_(key, itr->first))
+                itr = this->values_.emplace(itr, key, MT{});
+
+            return itr->second;
         }
     };
 
-    // extract only the top x from given data.
-    struct top
+    // the data as the flat container FT, a vector of the container value type
+    // becomes its storage, other containers are moved into it
+    template<typename FT, typename DT, typename CT>
+    FT flatConversion(DT &&data, CT compare)
     {
-        static constexpr auto operation = top_name();
+        if constexpr(std::is_same_v<std::decay_t<DT>, typename FT::storage_type>)
+            return FT{std::move(data), std::move(compare)};
+        else
+        {
+            FT results{std::move(compare)};
+            results.reserve(data.size());
+            results.insert(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+            return results;
+        }
+    }
 
-        unsigned int top_number_;
-        top(unsigned int number)
-            :top_number_(number)
-        { }
+    // linqcpp results as a flatSet, a sorted vector searched by binary search,
+    // as with asSet an orderBy predicate is used as the comparison
+    struct asFlatSet
+    {
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_flat_set();
 
-        // process top operation
-        // tuple_data_pack - not used in this operation
-        // data - take the top data from this container
+        // used by the extract process to get a requested flatSet type to
+        // store results
+        template<typename ST, typename ...TArgs>
+        auto results_collection(const TArgs& ...args) const
+        {
+            auto compare = orderingCompare(findOperation(order_by_name, args...));
+            return flatSet<ST, decltype(compare)>{compare};
+        }
+
+        // used by process list processing to convert current collection to
+        // flatSet if no extract operation defined
         template<typename TT, typename DT>
-        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        auto process(const TT &tuple_data_pack, DT &&data)
         {
-            if(data.size() > top_number_)
-            {
-                DT results;
-                results.reserve(top_number_);
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                     std::make_index_sequence<std::tuple_size<TT>{}>{});
 
-                std::copy_n(data.begin(), top_number_, std::back_inserter(results));
-                return results;
+            if constexpr(extract_op.operation!=default_indicator_name())
+                // existing extract operation return data unchanged
+                return std::move(data);
+            else
+            {
+                auto compare = orderingCompare(findOperationFromTuple(order_by_name, tuple_data_pack,
+                                                                      std::make_index_sequence<std::tuple_size<TT>{}>{}));
+                return flatConversion<flatSet<typename std::decay_t<DT>::value_type, decltype(compare)>>(
+                                std::move(data), compare);
             }
-
-            return std::move(data);
-
         }
     };
 
-    // extract only the bottom x from given data
-    struct bottom
+    // linqcpp results as a flatMap, a sorted vector of key value pairs
+    // searched by binary search, as with asMap an orderBy predicate is used
+    // as the comparison of the keys
+    struct asFlatMap
     {
-        static constexpr auto operation = bottom_name();
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_flat_map();
 
-        unsigned int bottom_number_;
-        bottom(unsigned int number)
-            :bottom_number_(number)
-        { }
+        // used by the extract process to get a requested flatMap type to
+        // store results
+        template<typename ST, typename ...TArgs>
+        auto results_collection(const TArgs& ...args) const
+        {
+            auto compare = orderingCompare(findOperation(order_by_name, args...));
+            return flatMap<typename ST::first_type, typename ST::second_type, decltype(compare)>{compare};
+        }
 
-        // process bottom operation
-        // tuple_data_pack - not used in this operation
-        // data - take the bottom from this container
+        // used by process list processing to convert current collection to
+        // flatMap if no extract operation defined
         template<typename TT, typename DT>
-        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        auto process(const TT &tuple_data_pack, DT &&data)
         {
-            if(data.size() > bottom_number_)
-            {
-                DT results;
-                results.reserve(bottom_number_);
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                     std::make_index_sequence<std::tuple_size<TT>{}>{});
 
-                auto itr = data.begin();
-                std::advance(itr, data.size() - bottom_number_);
-                std::copy_n(itr, bottom_number_, std::back_inserter(results));
+            if constexpr(extract_op.operation!=default_indicator_name())
+                // existing extract operation return data unchanged
+                return std::move(data);
+            else
+            {
+                using value_type = typename std::decay_t<DT>::value_type;
 
-                return results;
+                auto compare = orderingCompare(findOperationFromTuple(order_by_name, tuple_data_pack,
+                                                                      std::make_index_sequence<std::tuple_size<TT>{}>{}));
+                return flatConversion<flatMap<std::remove_const_t<typename value_type::first_type>,
+                                              typename value_type::second_type,
+                                              decltype(compare)>>(std::move(data), compare);
             }
-
-            return std::move(data);
-
         }
     };
 
-
-    // termination method to find number of the given named operation requested.
-    template<typename NT, typename OT>
-    constexpr auto numberOfNamedOperations(NT op_name, const OT &linq_op)
+    // spread the bits of std::hash, which is the identity for integers
+    inline size_t mixHash(size_t hash)
     {
-        if constexpr(OT::operation==op_name())
-            return 1;
-        else
-            return 0;
+        uint64_t value = hash;
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        return static_cast<size_t>(value);
     }
 
-    template<typename NT, typename FT, typename ...TArgs>
-    constexpr auto numberOfNamedOperations(NT op_name, const FT &first, const TArgs& ...args)
+    // the positions of the control bytes of a group of 16 equal to value, one
+    // bit for each byte. With SSE2 the group is compared in one instruction.
+    inline uint32_t matchGroup(const int8_t *group, int8_t value)
     {
-        if constexpr(FT::operation == op_name())
-            return numberOfNamedOperations(op_name, args...) + 1;
-        else
-            return numberOfNamedOperations(op_name, args...);
+    #if defined(__SSE2__)
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+    #else
+        uint32_t matches = 0;
+        for(uint32_t index = 0; index < 16; ++index)
+            matches |= static_cast<uint32_t>(group[index] == value) << index;
+        return matches;
+    #endif
     }
-    
-    // terminator point for the std linqcpp operator processing
-    template<typename TT, typename DT>
-    auto processOperationSequence([[maybe_unused]] const TT &tuple_pack, DT &&data)
+
+    // the position of the lowest set bit of a non zero mask
+    inline uint32_t lowestBit(uint32_t mask)
     {
-        return std::move(data);
+    #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>(__builtin_ctz(mask));
+    #else
+        uint32_t position = 0;
+        while(!(mask & 1))
+        {
+            mask >>= 1;
+            ++position;
+        }
+        return position;
+    #endif
     }
 
-    // clang8 is currently not correctly ignoring the other branch of the
-    // constexpr if so disabling the warning for now
-    #pragma clang diagnostic push
-    #pragma clang diagnostic ignored "-Wreturn-type"
-    // recursively process the linqcpp operations
-    template<typename TT, typename DT, typename FT, typename ...TArgs>
-    auto processOperationSequence([[maybe_unused]] const TT &tuple_pack, DT &&data, FT &front, TArgs& ...args)
+    // flatHashTable
+    // open addressed hash table of the flat hash containers. The elements are
+    // held in a vector in the order inserted, the table holds the position of
+    // each element. A control byte for each slot of the table holds the low 7
+    // bits of the hash of the slots element, or is empty, and the slots are
+    // probed a group of 16 control bytes at a time, the hash tag compared
+    // against the whole group at once. Only the elements whose tag matches
+    // are compared. KP gives the key of an element.
+    template<typename VT, typename KP, typename HT, typename EQ>
+    class flatHashTable
     {
-        // if operator is not an extract or from operation (extract operation is
-        // performed last and from has no operations) the perform processing and
-        // continue with processing for rest in list
-        if constexpr (FT::operation != extract_name() &&
-                      FT::operation != from_name())
+    public:
+        using value_type = VT;
+        using control_type = int8_t;
+        using size_type = size_t;
+        using hasher = HT;
+        using key_equal = EQ;
+        using iterator = typename std::vector<VT>::iterator;
+        using const_iterator = typename std::vector<VT>::const_iterator;
+
+        static constexpr size_t group_size_ = 16;
+
+        explicit flatHashTable(size_t expected = 0, HT hash = HT{}, EQ equal = EQ{})
+            :hash_(std::move(hash)), equal_(std::move(equal))
         {
-            auto result = front.process(tuple_pack, std::move(data));
-            return processOperationSequence(tuple_pack, std::move(result), args...);
+            reserve(expected);
         }
-        else
+
+        const_iterator begin() const { return values_.begin(); }
+        const_iterator end() const { return values_.end(); }
+        const_iterator cbegin() const { return values_.cbegin(); }
+        const_iterator cend() const { return values_.cend(); }
+
+        size_type size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+        size_type capacity() const { return values_.capacity(); }
+
+        void clear()
         {
-            return processOperationSequence(tuple_pack, std::move(data), args...);
+            values_.clear();
+            std::fill(control_.begin(), control_.end(), empty_);
         }
 
-    }
-    #pragma clang diagnostic pop
-    
-    // process 
-    template<typename ...TArgs>
-    auto processLinq(TArgs ...args)
-    {
-        static_assert(numberOfNamedOperations(to_collection_name, args...) < 2, 
-                "Only one container coversion can be specified");
-
-        static_assert(numberOfNamedOperations(order_by_name, args...) < 2,
-                "Only one orderBy operation can be specified");
+        // size the table for count elements, never shrinks it
+        void reserve(size_type count)
+        {
+            values_.reserve(count);
 
-        static_assert(numberOfNamedOperations(extract_name, args...) < 2,
-                "Only one extract operation can be specified");
+            size_t slots = group_size_;
+            while(slots - slots / 8 < count)
+                slots *= 2;
 
-        static_assert(numberOfNamedOperations(pre_sort_unique_name, args...) < 2,
-                "Only one pre sorted container unique operation can be specified");
+            if(slots > control_.size())
+                rehash(slots);
+        }
 
-        static_assert(numberOfNamedOperations(stable_unique_name, args...) < 2,
-                "Only one stable unique operation can be specified");
+        template<typename KT>
+        const_iterator find(const KT &key) const
+        {
+            auto position = findPosition(key, hashOf(key));
+            return position == npos_ ? values_.end() : values_.begin() + position;
+        }
 
-        auto from_op = findOperation(from_name, args...);
+        template<typename KT>
+        bool contains(const KT &key) const { return find(key) != end(); }
 
-        // put the linqcpp operations in a tuple list so it can be used as a
-        // second operations list for operation searches.
-        auto tuple_pack = std::tuple<TArgs...>(args...);
-        // process the linqcpp operations
-        auto process_results = processOperationSequence(tuple_pack,
-                                                        std::move(from_op.from_data), args...);
+        template<typename KT>
+        size_type count(const KT &key) const { return contains(key) ? 1 : 0; }
 
-        auto extract_op = findOperation(extract_name, args...);
-        if constexpr(decltype(extract_op)::operation!=default_indicator_name())
+        // insert the value if no element with an equal key is held, the
+        // element held and if the value was inserted
+        std::pair<iterator, bool> insert(VT value)
         {
-            // extract operation performed last to ensure data contains all
+            auto hash = hashOf(KP{}(value));
+            auto position = findPosition(KP{}(value), hash);
+            if(position != npos_)
+                return {values_.begin() + position, false};
+
+            return {emplaceNew(hash, std::move(value)), true};
+        }
+
+        // the hint is not used, for std::inserter
+        iterator insert([[maybe_unused]] const_iterator hint, VT value)
+        {
+            return insert(std::move(value)).first;
+        }
+
+        // equal when the same keys are held with equal elements
+        bool operator==(const flatHashTable &other) const
+        {
+            if(size() != other.size())
+                return false;
+
+            return std::all_of(values_.begin(), values_.end(), [&other](const VT &value) {
+                                   auto itr = other.find(KP{}(value));
+                                   return itr != other.end() && *itr == value;
+                               });
+        }
+
+        bool operator!=(const flatHashTable &other) const { return !(*this == other); }
+
+    protected:
+        static constexpr control_type empty_ = std::numeric_limits<control_type>::min();
+        static constexpr size_t npos_ = std::numeric_limits<size_t>::max();
+
+        std::vector<VT> values_;
+        std::vector<control_type> control_;
+        std::vector<uint32_t> slots_;
+        HT hash_;
+        EQ equal_;
+
+        // the hash of the key with its bits spread, the low 7 bits are the tag
+        // of the control byte and the bits above select the first group
+        template<typename KT>
+        size_t hashOf(const KT &key) const
+        {
+            return mixHash(hash_(key));
+        }
+
+        size_t firstGroup(size_t hash) const
+        {
+            return (hash >> 7) & (control_.size() / group_size_ - 1);
+        }
+
+        static control_type tag(size_t hash)
+        {
+            return static_cast<control_type>(hash & 0x7f);
+        }
+
+        // the position of the element with the key in values_, probing the
+        // groups in triangular steps which visits each group once
+        template<typename KT>
+        size_t findPosition(const KT &key, size_t hash) const
+        {
+            if(control_.empty())
+                return npos_;
+
+            auto group_mask = control_.size() / group_size_ - 1;
+            auto group = firstGroup(hash);
+            auto hash_tag = tag(hash);
+
+            for(size_t step = 1; ; ++step)
+            {
+                auto group_control = control_.data() + group * group_size_;
+                for(auto matches = matchGroup(group_control, hash_tag); matches != 0; matches &= matches - 1)
+                {
+                    auto position = slots_[group * group_size_ + lowestBit(matches)];
+                    if(equal_(KP{}(values_[position]), key))
+                        return position;
+                }
+
+                // an empty slot ends the probing, the key would be held before it
+                if(matchGroup(group_control, empty_) != 0)
+                    return npos_;
+
+                group = (group + step) & group_mask;
+            }
+        }
+
+        // the first empty slot of the probe sequence for the hash
+        void placePosition(size_t hash, uint32_t position)
+        {
+            auto group_mask = control_.size() / group_size_ - 1;
+            auto group = firstGroup(hash);
+
+            for(size_t step = 1; ; ++step)
+            {
+                auto empties = matchGroup(control_.data() + group * group_size_, empty_);
+                if(empties != 0)
+                {
+                    auto slot = group * group_size_ + lowestBit(empties);
+                    control_[slot] = tag(hash);
+                    slots_[slot] = position;
+                    return;
+                }
+
+                group = (group + step) & group_mask;
+            }
+        }
+
+        template<typename ...AT>
+        iterator emplaceNew(size_t hash, AT&& ...args)
+        {
+            if(values_.size() >= std::numeric_limits<uint32_t>::max())
+                throw std::length_error("linqcpp flat hash container holds at most 2^32 - 1 elements");
+
+            // at most 7/8 of the slots are used
+            auto slots = control_.size();
+            if(values_.size() + 1 > slots - slots / 8)
+                rehash(std::max(group_size_, slots * 2));
+
+            values_.emplace_back(std::forward<AT>(args)...);
+            placePosition(hash, static_cast<uint32_t>(values_.size() - 1));
+            return std::prev(values_.end());
+        }
+
+        // rebuild the table with the given number of slots, the elements do
+        // not move, only their positions are placed again
+        void rehash(size_t slots)
+        {
+            control_.assign(slots, empty_);
+            slots_.assign(slots, 0);
+
+            for(size_t position = 0; position < values_.size(); ++position)
+                placePosition(hashOf(KP{}(values_[position])), static_cast<uint32_t>(position));
+        }
+    };
+
+    // flatHashSet
+    // a hash set held in a vector of the elements in the order inserted and
+    // an open addressed table of their positions probed with SIMD group
+    // compares, no allocation for each element
+    template<typename T, typename HT = std::hash<T>, typename EQ = std::equal_to<>>
+    class flatHashSet : public flatHashTable<T, flatSetKey, HT, EQ>
+    {
+    public:
+        using key_type = T;
+
+        // as with std::unordered_set the elements can not be changed through
+        // iterators
+        using iterator = typename flatHashTable<T, flatSetKey, HT, EQ>::const_iterator;
+
+        using flatHashTable<T, flatSetKey, HT, EQ>::flatHashTable;
+    };
+
+    // flatHashMap
+    // a hash map held in a vector of key value pairs in the order inserted and
+    // an open addressed table of their positions, the keys must not be changed
+    // through the iterators
+    template<typename KT, typename MT, typename HT = std::hash<KT>, typename EQ = std::equal_to<>>
+    class flatHashMap : public flatHashTable<std::pair<KT, MT>, flatMapKey, HT, EQ>
+    {
+        using base_type = flatHashTable<std::pair<KT, MT>, flatMapKey, HT, EQ>;
+
+    public:
+        using key_type = KT;
+        using mapped_type = MT;
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
+
+        using base_type::base_type;
+        using base_type::begin;
+        using base_type::end;
+        using base_type::find;
+
+        iterator begin() { return this->values_.begin(); }
+        iterator end() { return this->values_.end(); }
+
+        template<typename LT>
+        iterator find(const LT &key)
+        {
+            auto position = this->findPosition(key, this->hashOf(key));
+            return position == base_type::npos_ ? this->values_.end() : this->values_.begin() + position;
+        }
+
+        MT &at(const KT &key)
+        {
+            auto itr = find(key);
+            if(itr == end())
+                throw std::out_of_range("linqcpp flatHashMap key not found");
+
+            return itr->second;
+        }
+
+        const MT &at(const KT &key) const
+        {
+            auto itr = find(key);
+            if(itr == end())
+                throw std::out_of_range("linqcpp flatHashMap key not found");
+
+            return itr->second;
+        }
+
+        // the value of the key, a default value is inserted for a key not held
+        MT &operator[](const KT &key)
+        {
+            auto hash = this->hashOf(key);
+            auto position = this->findPosition(key, hash);
+            if(position != base_type::npos_)
+                return this->values_[position].second;
+
+            return this->emplaceNew(hash, key, MT{})->second;
+        }
+    };
+
+    // linqcpp results as a flatHashSet, sized once for the number of
+    // elements processed
+    struct asFlatHashSet
+    {
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_flat_hash_set();
+
+        // used by the extract process to get a requested flatHashSet type to
+        // store results, the extract sizes it for the data
+        template<typename ST, typename ...TArgs>
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
+        {
+            return flatHashSet<ST>{};
+        }
+
+        // used by process list processing to convert current collection to
+        // flatHashSet if no extract operation defined
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                     std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            if constexpr(extract_op.operation!=default_indicator_name())
+                // existing extract operation, return data unchanged
+                return std::move(data);
+            else
+            {
+                // sized once then the data moved in
+                flatHashSet<typename std::decay_t<DT>::value_type> results{data.size()};
+                for(auto &value : data)
+                    results.insert(std::move(value));
+
+                return results;
+            }
+        }
+    };
+
+    // linqcpp results as a flatHashMap, sized once for the number of
+    // elements processed
+    struct asFlatHashMap
+    {
+        static constexpr auto operation = to_collection_name();
+        static constexpr auto container_type = as_flat_hash_map();
+
+        // used by the extract process to get a requested flatHashMap type to
+        // store results, the extract sizes it for the data
+        template<typename ST, typename ...TArgs>
+        auto results_collection([[maybe_unused]] const TArgs& ...args) const
+        {
+            return flatHashMap<typename ST::first_type, typename ST::second_type>{};
+        }
+
+        // used by process list processing to convert current collection to
+        // flatHashMap if no extract operation defined
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto extract_op = findOperationFromTuple(extract_name, tuple_data_pack,
+                                                     std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            if constexpr(extract_op.operation!=default_indicator_name())
+                // existing extract operation, return data unchanged
+                return std::move(data);
+            else
+            {
+                using value_type = typename std::decay_t<DT>::value_type;
+
+                // sized once then the data moved in
+                flatHashMap<std::remove_const_t<typename value_type::first_type>,
+                            typename value_type::second_type> results{data.size()};
+                for(auto &value : data)
+                    results.insert(std::move(value));
+
+                return results;
+            }
+        }
+    };
+
+
+    // estimate of the heap bytes each element of the container type takes,
+    // the element and, for node based containers, its node links
+    template<typename RT>
+    constexpr size_t elementAllocatedBytes()
+    {
+        using value_type = typename RT::value_type;
+
+        if constexpr(std::experimental::is_detected<flat_storage_type, RT>::value)
+            return sizeof(value_type);                                      // sorted vector
+        else if constexpr(std::experimental::is_detected<flat_hash_type, RT>::value)
+            return sizeof(value_type) + 2 * (sizeof(uint32_t) + 1);         // up to two slots each
+        else if constexpr(std::experimental::is_detected<contains_bucket_count, RT>::value)
+            return sizeof(value_type) + 2 * sizeof(void*) + sizeof(size_t); // node, cached hash, bucket
+        else if constexpr(std::experimental::is_detected<contains_key_compare, RT>::value)
+            return sizeof(value_type) + 4 * sizeof(void*);                  // tree node links and colour
+        else if constexpr(std::experimental::is_detected<contains_sort, RT>::value)
+            return sizeof(value_type) + 2 * sizeof(void*);                  // list node links
+        else
+            return sizeof(value_type);
+    }
+
+    // compile time check for an element type that can own heap storage that
+    // can be measured, strings, containers, pairs of them and types with an
+    // ownedBytes() method
+    template<typename T>
+    constexpr bool ownsMeasurableStorage()
+    {
+        if constexpr(std::experimental::is_detected<contains_owned_bytes, T>::value)
+            return true;
+        else if constexpr(std::experimental::is_detected<pair_first_type, T>::value)
+            return ownsMeasurableStorage<std::remove_const_t<typename T::first_type>>() ||
+                   ownsMeasurableStorage<typename T::second_type>();
+        else
+            return std::experimental::is_detected<contains_elements, T>::value;
+    }
+
+    template<typename RT>
+    size_t estimatedAllocatedBytes(const RT &results);
+
+    // heap bytes owned by an element, 0 for the types that can not be measured
+    template<typename T>
+    size_t ownedBytes(const T &value)
+    {
+        if constexpr(std::experimental::is_detected<contains_owned_bytes, T>::value)
+            return value.ownedBytes();
+        else if constexpr(std::experimental::is_detected<pair_first_type, T>::value)
+            return ownedBytes(value.first) + ownedBytes(value.second);
+        else if constexpr(std::experimental::is_detected<contains_elements, T>::value)
+            return estimatedAllocatedBytes(value);
+        else
+            return 0;
+    }
+
+    // the bytes of the storage of results while room is made for one more
+    // element, a full contiguous container holds its old storage and its new
+    // storage of twice the capacity as it grows
+    template<typename RT>
+    size_t bytesToAppend(const RT &results)
+    {
+        if constexpr(std::experimental::is_detected<contains_reserve, RT>::value &&
+                     !std::experimental::is_detected<contains_bucket_count, RT>::value &&
+                     !std::experimental::is_detected<flat_hash_type, RT>::value &&
+                     !std::experimental::is_detected<small_buffer_type, RT>::value)
+        {
+            auto capacity = results.capacity();
+            if(results.size() < capacity)
+                return capacity * sizeof(typename RT::value_type);
+
+            return (capacity + std::max<size_t>(1, 2 * capacity)) * sizeof(typename RT::value_type);
+        }
+        else
+            return (results.size() + 1) * elementAllocatedBytes<RT>();
+    }
+
+    // make room in results for one more element, a full contiguous container
+    // grows to twice its capacity as bytesToAppend counts
+    template<typename RT>
+    void makeRoomToAppend([[maybe_unused]] RT &results)
+    {
+        if constexpr(std::experimental::is_detected<contains_reserve, RT>::value &&
+                     !std::experimental::is_detected<contains_bucket_count, RT>::value &&
+                     !std::experimental::is_detected<flat_hash_type, RT>::value &&
+                     !std::experimental::is_detected<small_buffer_type, RT>::value)
+        {
+            if(results.size() == results.capacity())
+                results.reserve(std::max<size_t>(1, 2 * results.capacity()));
+        }
+    }
+
+    // estimate of the heap bytes the container holds, its storage and the
+    // storage owned by the elements where it can be measured
+    template<typename RT>
+    size_t estimatedAllocatedBytes(const RT &results)
+    {
+        size_t bytes = 0;
+        if constexpr(std::experimental::is_detected<small_buffer_type, RT>::value)
+            bytes = results.isInline() ? 0 : results.capacity() * sizeof(typename RT::value_type);
+        else if constexpr(std::experimental::is_detected<contains_reserve, RT>::value &&
+                          !std::experimental::is_detected<contains_bucket_count, RT>::value &&
+                          !std::experimental::is_detected<flat_hash_type, RT>::value)
+        {
+            // a short string is held within the string itself
+            bool held_in_place = false;
+            if constexpr(std::experimental::is_detected<contains_data, RT>::value)
+            {
+                auto storage = static_cast<const void *>(results.data());
+                auto object = reinterpret_cast<const char *>(std::addressof(results));
+                held_in_place = !std::less<const void *>{}(storage, object) &&
+                                std::less<const void *>{}(storage, object + sizeof(RT));
+            }
+
+            bytes = held_in_place ? 0 : results.capacity() * sizeof(typename RT::value_type);
+        }
+        else
+            bytes = results.size() * elementAllocatedBytes<RT>();
+
+        if constexpr(ownsMeasurableStorage<typename RT::value_type>())
+        {
+            for(const auto &value : results)
+                bytes += ownedBytes(value);
+        }
+
+        return bytes;
+    }
+
+    // size the results container, that can reserve, up front for the
+    // required number of elements
+    template<typename RT>
+    void reserveCollection([[maybe_unused]] RT &results, [[maybe_unused]] size_t required_size)
+    {
+        if constexpr(std::experimental::is_detected<contains_reserve, RT>::value)
+        {
+            // unordered containers reserve can rehash down to a smaller
+            // bucket array, so only reserve when the buckets are too few
+            if constexpr(std::experimental::is_detected<contains_bucket_count, RT>::value)
+            {
+                if(required_size > results.bucket_count() * results.max_load_factor())
+                    results.reserve(required_size);
+            }
+            else
+                results.reserve(required_size);
+        }
+    }
+
+    // fill the results container with the transformed range, results containers
+    // with a push_back method are appended to, otherwise the containers insert
+    // method is used. Containers that can reserve are sized up front, a
+    // container that already has the capacity keeps it.
+    template<typename RT, typename IT, typename OP>
+    void fillCollection(RT &results, IT first, IT last, OP &operation)
+    {
+        using value_type = decltype(operation(*first));
+
+        reserveCollection(results, results.size() + std::distance(first, last));
+
+        if constexpr(std::experimental::is_detected<flat_storage_type, RT>::value)
+        {
+            // flat containers take all of the values then order them once
+            results.bulkInsert([&](auto inserter) { std::transform(first, last, inserter, operation); });
+        }
+        else if constexpr(std::experimental::is_detected<contains_key_compare, RT>::value &&
+                          std::is_move_assignable_v<std::decay_t<value_type>>)
+        {
+            // ordered tree containers take the values in key order, so each is
+            // inserted without a search
+            std::vector<std::decay_t<value_type>> values;
+            values.reserve(std::distance(first, last));
+            std::transform(first, last, std::back_inserter(values), operation);
+            sortedInsert(results, values);
+        }
+        else if constexpr(std::experimental::is_detected<contains_push_back, RT, value_type>::value)
+        {
+            // results container has a push_back method so use back_inserter
+            // to fill the results container
+            std::transform(first, last, std::back_inserter(results), operation);
+        }
+        else if constexpr(std::experimental::is_detected<contains_insert, RT, value_type>::value)
+        {
+            // results container has insert method use std::inserter
+            std::transform(first, last, std::inserter(results, results.end()), operation);
+        }
+        else
+        {
+            // neither push_back or insert method exists, compile time error out
+            constexpr bool error = std::experimental::is_detected<contains_push_back, RT, value_type>::value
+                                   ||
+                                   std::experimental::is_detected<contains_insert, RT, value_type>::value;
+
+            static_assert(error, "results container has no push_back or insert methods");
+        }
+    }
+
+    // thrown out of a processing cancelled through its cancellation token
+    struct queryCancelled : std::runtime_error
+    {
+        queryCancelled(const char *reason = "linqcpp query cancelled")
+            :std::runtime_error(reason)
+        { }
+    };
+
+    // thrown out of a processing that ran past its deadline
+    struct queryDeadlineExceeded : queryCancelled
+    {
+        queryDeadlineExceeded()
+            :queryCancelled("linqcpp query deadline exceeded")
+        { }
+    };
+
+    // shared cancellation state, copies of a token cancel the same processing
+    class cancellationToken
+    {
+    public:
+        void cancel() { cancelled_->store(true, std::memory_order_relaxed); }
+        bool cancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+    private:
+        friend struct cancelWhen;
+
+        std::shared_ptr<std::atomic<bool>> cancelled_ = std::make_shared<std::atomic<bool>>(false);
+    };
+
+    // cancellation operation
+    // the processing checks the token and the deadline between its stages,
+    // and the where, orderBy and extract loops check them after each chunk of
+    // elements, throwing queryCancelled or queryDeadlineExceeded. A deadline
+    // given as a duration is measured from the construction of the operation.
+    struct cancelWhen
+    {
+        static constexpr auto operation = cancellation_name();
+
+        // elements processed between checks
+        static constexpr size_t chunk_size_ = 4096;
+
+        // the flag of the token, null without a token. Held directly rather
+        // than as an optional token, which g++ reports as maybe used
+        // uninitialized when the operation is copied into the tuple.
+        std::shared_ptr<const std::atomic<bool>> cancelled_;
+        std::optional<std::chrono::steady_clock::time_point> deadline_;
+
+        cancelWhen(cancellationToken token)
+            :cancelled_(std::move(token.cancelled_))
+        { }
+
+        cancelWhen(std::chrono::steady_clock::time_point deadline)
+            :deadline_(deadline)
+        { }
+
+        cancelWhen(cancellationToken token, std::chrono::steady_clock::time_point deadline)
+            :cancelled_(std::move(token.cancelled_)), deadline_(deadline)
+        { }
+
+        template<typename RP, typename PD>
+        cancelWhen(std::chrono::duration<RP, PD> timeout)
+            :deadline_(std::chrono::steady_clock::now() + timeout)
+        { }
+
+        template<typename RP, typename PD>
+        cancelWhen(cancellationToken token, std::chrono::duration<RP, PD> timeout)
+            :cancelled_(std::move(token.cancelled_)), deadline_(std::chrono::steady_clock::now() + timeout)
+        { }
+
+        void check() const
+        {
+            if(cancelled_ && cancelled_->load(std::memory_order_relaxed))
+                throw queryCancelled{};
+
+            if(deadline_ && std::chrono::steady_clock::now() >= *deadline_)
+                throw queryDeadlineExceeded{};
+        }
+    };
+
+    // process the range in chunks, checking the cancellation operation after
+    // each chunk, without a cancellation operation the range is processed in
+    // one call
+    template<typename IT, typename CT, typename FT>
+    void processChunks(IT first, IT last, [[maybe_unused]] const CT &cancel_op, FT process)
+    {
+        if constexpr(CT::operation == default_indicator_name())
+        {
+            process(first, last);
+        }
+        else
+        {
+            auto remaining = static_cast<size_t>(std::distance(first, last));
+            while(remaining > 0)
+            {
+                auto count = std::min(remaining, cancelWhen::chunk_size_);
+                auto chunk_last = std::next(first, count);
+
+                process(first, chunk_last);
+                cancel_op.check();
+
+                first = chunk_last;
+                remaining -= count;
+            }
+        }
+    }
+
+    // thrown when a processing would go over its memory budget
+    struct memoryBudgetExceeded : std::runtime_error
+    {
+        std::string_view operation_;
+        size_t required_bytes_;
+        size_t budget_bytes_;
+
+        memoryBudgetExceeded(std::string_view operation, size_t required_bytes, size_t budget_bytes)
+            :std::runtime_error("linqcpp memory budget exceeded by " + std::string{operation} + ", " +
+                                std::to_string(required_bytes) + " bytes required of a " +
+                                std::to_string(budget_bytes) + " byte budget"),
+             operation_(operation), required_bytes_(required_bytes), budget_bytes_(budget_bytes)
+        { }
+    };
+
+    // what a processing does when a stage would go over its memory budget,
+    // fail before the stage runs, or run a stage that supports it through the
+    // disk (and fail for the other stages). The policies are types so a spill
+    // policy given to a query with no stage that can spill does not compile.
+    namespace budget_policy
+    {
+        struct fail_fast_policy { };
+        struct spill_policy { };
+
+        inline constexpr fail_fast_policy fail_fast{};
+        inline constexpr spill_policy spill{};
+    }
+
+    // the memory used by a processing, the bytes held by its containers and
+    // the stage working storage, and the operations that spilled to disk
+    struct memoryUsage
+    {
+        size_t live_bytes_ = 0;
+        size_t peak_bytes_ = 0;
+        std::vector<std::string_view> spilled_;
+    };
+
+    // memoryBudget operation
+    // limits the memory a processing holds, the source copy, the results of
+    // each stage still held and the working storage of the running stage
+    // (the hash set of a stableUnique, the results of a conversion). Before
+    // each stage the bytes it will allocate are estimated from its input, a
+    // stage that would go over the budget throws memoryBudgetExceeded before
+    // it runs, or with budget_policy::spill runs through the disk if it can.
+    // The stages that can spill are a stableUnique with no predicate of
+    // trivially copyable elements, and an orderBy of the trivially copyable
+    // elements of a source read in place followed only by an extract, which
+    // is sorted through an externalSort and merged into the results. A spill
+    // policy for a query with neither does not compile. The results of a
+    // where, or an index lookup or where on a source read in place, are not
+    // known before it runs, each element is checked as it is added, before
+    // the storage it needs is allocated.
+    // The byte counts are estimates, not a count of the allocations made,
+    // of the container storage and the heap storage owned by the elements
+    // where it can be measured: strings, containers, pairs of them and
+    // elements with a size_t ownedBytes() method. Storage owned by other
+    // elements is not counted. The usage, if given, reports the peak bytes
+    // and the stages that spilled.
+    template<typename PT = budget_policy::fail_fast_policy>
+    struct memoryBudget
+    {
+        static constexpr auto operation = memory_budget_name();
+        static constexpr bool spill_ = std::is_same_v<PT, budget_policy::spill_policy>;
+
+        size_t budget_bytes_;
+        std::shared_ptr<memoryUsage> own_usage_;
+        memoryUsage *usage_;
+
+        memoryBudget(size_t budget_bytes, [[maybe_unused]] PT policy = PT{})
+            :budget_bytes_(budget_bytes),
+             own_usage_(std::make_shared<memoryUsage>()), usage_(own_usage_.get())
+        { }
+
+        memoryBudget(size_t budget_bytes, memoryUsage &usage, [[maybe_unused]] PT policy = PT{})
+            :budget_bytes_(budget_bytes), usage_(&usage)
+        { }
+
+        // start of a processing holding source_bytes of source data
+        void start(size_t source_bytes) const
+        {
+            *usage_ = memoryUsage{source_bytes, source_bytes, {}};
+            if(source_bytes > budget_bytes_)
+                throw memoryBudgetExceeded{from_name(), source_bytes, budget_bytes_};
+        }
+
+        // the bytes still available
+        size_t available() const
+        {
+            return budget_bytes_ - std::min(budget_bytes_, usage_->live_bytes_);
+        }
+
+        // check the bytes a stage will allocate are within the budget
+        bool fits(size_t stage_bytes) const
+        {
+            return usage_->live_bytes_ + stage_bytes <= budget_bytes_;
+        }
+
+        [[noreturn]] void exceeded(std::string_view operation_name, size_t stage_bytes) const
+        {
+            throw memoryBudgetExceeded{operation_name, usage_->live_bytes_ + stage_bytes, budget_bytes_};
+        }
+
+        void spilled(std::string_view operation_name) const
+        {
+            usage_->spilled_.push_back(operation_name);
+        }
+
+        // the running stage is about to hold stage_bytes, checked before they
+        // are allocated
+        void growing(std::string_view operation_name, size_t stage_bytes) const
+        {
+            if(!fits(stage_bytes))
+                exceeded(operation_name, stage_bytes);
+
+            usage_->peak_bytes_ = std::max(usage_->peak_bytes_, usage_->live_bytes_ + stage_bytes);
+        }
+
+        // a stage has finished, input_bytes were held by its input before and
+        // input_after after (none if the input was moved to the results),
+        // working_bytes were used while it ran
+        void finished(std::string_view operation_name, size_t input_bytes, size_t input_after,
+                      size_t result_bytes, size_t working_bytes) const
+        {
+            auto before = usage_->live_bytes_;
+            usage_->live_bytes_ = before - std::min(before, input_bytes) + input_after + result_bytes;
+
+            // an input moved to the results is not held twice
+            auto during = input_after == 0 && input_bytes != 0 ? before + working_bytes : usage_->live_bytes_;
+            usage_->peak_bytes_ = std::max({usage_->peak_bytes_, during, usage_->live_bytes_});
+
+            if(usage_->peak_bytes_ > budget_bytes_)
+                throw memoryBudgetExceeded{operation_name, usage_->peak_bytes_, budget_bytes_};
+        }
+    };
+
+    // appends the elements a stage selects to its results. Without a memory
+    // budget each element is pushed back, with one the storage each element
+    // needs, the growth of the results and the heap storage of a copied
+    // element, is checked against the budget before it is allocated.
+    template<typename BT = defaultIndicator>
+    struct stageAppend
+    {
+        BT budget_op_;
+        std::string_view operation_;
+        size_t owned_bytes_ = 0;
+
+        // room for count more elements
+        template<typename RT>
+        void reserve(RT &results, size_t count)
+        {
+            if constexpr(BT::operation != default_indicator_name())
+                budget_op_.growing(operation_, (results.size() + count) * elementAllocatedBytes<RT>() + owned_bytes_);
+
+            reserveCollection(results, results.size() + count);
+        }
+
+        template<typename RT, typename VT>
+        void operator()(RT &results, VT &&value)
+        {
+            // a copy owns new storage, a moved element brings its own
+            if constexpr(BT::operation != default_indicator_name())
+                makeRoom(results, std::is_lvalue_reference_v<VT> ? ownedBytes(value) : 0);
+
+            results.push_back(std::forward<VT>(value));
+        }
+
+        // append a value made by the stage, the storage it owns is new
+        template<typename RT, typename VT>
+        void appendNew(RT &results, VT &&value)
+        {
+            if constexpr(BT::operation != default_indicator_name())
+                makeRoom(results, ownedBytes(value));
+
+            results.push_back(std::forward<VT>(value));
+        }
+
+    private:
+        // room for one more element owning value_bytes, checked against the
+        // budget before it is allocated
+        template<typename RT>
+        void makeRoom(RT &results, size_t value_bytes)
+        {
+            budget_op_.growing(operation_, bytesToAppend(results) + owned_bytes_ + value_bytes);
+            makeRoomToAppend(results);
+            owned_bytes_ += value_bytes;
+        }
+    };
+
+    // the appender of a stage, checked against the memory budget of the
+    // operations if there is one
+    template<typename TT>
+    auto makeStageAppend(const TT &tuple_pack, std::string_view operation_name)
+    {
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+        return stageAppend<decltype(budget_op)>{std::move(budget_op), operation_name};
+    }
+
+    // extract operation
+    // extracts the data defined in the predicate and puts the results into the
+    // defined container or std::vector if container is not defined
+    template<typename ST>
+    struct extract
+    {
+        static constexpr auto operation = extract_name();
+
+        ST extract_operation_;
+        extract(ST &&extract_op)
+            :extract_operation_(std::move(extract_op))
+        { }
+
+        // process the extraction
+        // data - container to perform the extract operation on
+        // args - compile time list from which to obtain the results container
+        //        and the from operation to help with figuring out the type of
+        //        the result.
+        template<typename DT, typename ...TArgs>
+        auto process(DT &&data, const TArgs& ...args)
+        {
+            // find if the container for the results is defined (returned
+            // default is std::vector)
+            auto result_type = findOperation(to_collection_name, args...);
+
+            // obtain the results container given the type of the data to be
+            // extracted, the type comes from the processed data as operations
+            // such as window change the type of the data
+            using extract_type = std::decay_t<decltype(extract_operation_(*ownedIterator(data.begin())))>;
+            auto results = result_type.template results_collection<extract_type>(args...);
+
+            processInto(results, std::move(data), args...);
+
+            return results;
+        }
+
+        // process the extraction into a caller provided results container
+        // results - container to append the extracted data to
+        // data - container to perform the extract operation on
+        // args - the operations, a cancellation operation is checked after
+        //        each chunk of the data
+        template<typename RT, typename DT, typename ...TArgs>
+        void processInto(RT &results, DT &&data, const TArgs& ...args)
+        {
+            auto cancel_op = findOperation(cancellation_name, args...);
+
+            // sized once for all of the data, each chunk then fits
+            if constexpr(cancel_op.operation != default_indicator_name())
+                reserveCollection(results, results.size() + data.size());
+
+            // a flat container takes all of the chunks then orders them once
+            if constexpr(std::experimental::is_detected<flat_storage_type, RT>::value)
+            {
+                reserveCollection(results, results.size() + data.size());
+                results.bulkInsert([&](auto inserter) {
+                                       processChunks(data.begin(), data.end(), cancel_op, [&](auto first, auto last) {
+                                                         inserter = std::transform(ownedIterator(first), ownedIterator(last),
+                                                                                   inserter, extract_operation_);
+                                                     });
+                                   });
+            }
+            else
+            {
+                processChunks(data.begin(), data.end(), cancel_op, [&](auto first, auto last) {
+                                  fillCollection(results, ownedIterator(first), ownedIterator(last), extract_operation_);
+                              });
+            }
+        }
+
+        // the data is owned by the processing, an extraction that takes its
+        // element by value or rvalue reference is given the elements as
+        // rvalues so it can move from them
+        template<typename IT>
+        auto ownedIterator(IT itr) const
+        {
+            if constexpr(std::is_invocable_v<ST&, decltype(*std::make_move_iterator(itr))>)
+                return std::make_move_iterator(itr);
+            else
+                return itr;
+        }
+    };
+
+    // from operation
+    // required process for linqcpp to work, takes a copy of the data because
+    // the data can be sorted, transformed and truncated before being put into
+    // another container. So design decision is to take the data by value as a
+    // copy will be required anyway for any of those operations to be performed.
+    // Data given as an rvalue is moved in, the data is then moved from stage
+    // to stage so elements can be move only.
+    template<typename FT>
+    struct from
+    {
+        static constexpr auto operation = from_name();
+        using value_type = typename FT::value_type;
+
+        FT from_data;
+        from(FT from_dt)
+            :from_data(std::move(from_dt))
+        { }
+
+        // The value in the data container needs to be default constructable.
+        auto valueTypeValue() { return value_type{}; }
+
+    };
+
+    // where operation
+    // to filter the data based on the where_operation predicate
+    template<typename WT>
+    struct where
+    {
+        static constexpr auto operation = where_name();
+
+        WT where_operation_;
+        where(WT &&where_op)
+            :where_operation_(std::move(where_op))
+        { }
+
+        // process the where filter
+        // tuple_data_pack - searched for a cancellation operation and a memory
+        //                   budget that each element kept is checked against
+        // data - the data on which to perform the filter operation
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            auto cancel_op = findOperationFromTuple(cancellation_name, tuple_data_pack,
+                                                    std::make_index_sequence<std::tuple_size<TT>{}>{});
+            auto append = makeStageAppend(tuple_data_pack, where_name());
+
+            DT results;
+            processChunks(data.begin(), data.end(), cancel_op, [&](auto first, auto last) {
+                              // a list relinks the nodes that pass into the
+                              // results rather than copying the elements
+                              if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+                              {
+                                  while(first != last)
+                                  {
+                                      auto current = first++;
+                                      if(where_operation_(*current))
+                                          results.splice(results.end(), data, current);
+                                  }
+                              }
+                              else
+                              {
+                                  // the data is owned, the elements that pass
+                                  // are moved into the results
+                                  for(; first != last; ++first)
+                                  {
+                                      if(where_operation_(*first))
+                                          append(results, std::move(*first));
+                                  }
+                              }
+                          });
+
+            return results;
+        }
+
+        // the number of results is not known before the filter runs, a memory
+        // budget checks each element as it is kept
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, [[maybe_unused]] const DT &data) const
+        {
+            return 0;
+        }
+    };
+
+    // the structure a keyMembership holds its keys in
+    enum class membership_type { sorted_vector, flat_hash, bitmap };
+
+    // keyMembership
+    // where predicate testing the projected key of an element for membership
+    // of a set of keys. The structure is picked by the number and type of the
+    // keys, a bitmap for integral keys in a dense range, a sorted vector with
+    // a branchless binary search for small sets (or keys with no std::hash)
+    // and an open addressed flat hash set for large sets. An optional Bloom
+    // filter is tested before the sorted vector or hash set, when most
+    // elements do not match it answers most tests from a small bit array.
+    template<typename PT, typename KT>
+    class keyMembership
+    {
+    public:
+        // the most keys held in a sorted vector when the keys can be hashed
+        static constexpr size_t sorted_vector_max_keys_ = 512;
+
+        template<typename IT>
+        keyMembership(PT projection, IT first, IT last, bool negate, bool bloom_prefilter)
+            :projection_(std::move(projection)), negate_(negate)
+        {
+            std::vector<KT> keys(first, last);
+
+            if constexpr(is_bitmap_key)
+            {
+                if(!keys.empty())
+                {
+                    auto [min, max] = std::minmax_element(keys.begin(), keys.end());
+                    auto range = static_cast<uint64_t>(toUnsigned(*max) - toUnsigned(*min));
+
+                    // at most 64 bits, the size of a hash set slot, a key
+                    if(range / 64 < keys.size())
+                    {
+                        buildBitmap(keys, *min, range);
+                        return;
+                    }
+                }
+            }
+
+            constexpr bool hashable = std::experimental::is_detected<contains_hash, KT>::value;
+            constexpr bool ordered = std::experimental::is_detected<contains_less, KT>::value;
+            static_assert(hashable || ordered, "linqcpp - whereIn keys need a std::hash or an operator<");
+
+            if constexpr(ordered)
+            {
+                if(!hashable || keys.size() <= sorted_vector_max_keys_)
+                {
+                    std::sort(keys.begin(), keys.end());
+                    keys.erase(std::unique(keys.begin(), keys.end(),
+                                           [](const KT &lhs, const KT &rhs) { return !(lhs < rhs) && !(rhs < lhs); }),
+                               keys.end());
+                    sorted_keys_ = std::move(keys);
+                    structure_ = membership_type::sorted_vector;
+                }
+            }
+
+            if constexpr(hashable)
+            {
+                if(structure_ != membership_type::sorted_vector)
+                    buildHash(keys);
+
+                // the keys were moved to the sorted vector when it is used
+                if(bloom_prefilter)
+                    buildBloom(structure_ == membership_type::sorted_vector ? sorted_keys_ : keys);
+            }
+        }
+
+        template<typename VT>
+        bool operator()(const VT &value) const
+        {
+            return contains(projection_(value)) != negate_;
+        }
+
+        bool contains(const KT &key) const
+        {
+            if constexpr(is_bitmap_key)
+            {
+                if(structure_ == membership_type::bitmap)
+                {
+                    if(key < bitmap_min_ || bitmap_max_ < key)
+                        return false;
+
+                    auto bit = static_cast<uint64_t>(toUnsigned(key) - toUnsigned(bitmap_min_));
+                    return (bitmap_[bit >> 6] >> (bit & 63)) & 1;
+                }
+            }
+
+            if constexpr(std::experimental::is_detected<contains_hash, KT>::value)
+            {
+                if(!bloom_.empty() && !bloomContains(mixHash(std::hash<KT>{}(key))))
+                    return false;
+
+                if(structure_ == membership_type::flat_hash)
+                    return hashContains(key);
+            }
+
+            if constexpr(std::experimental::is_detected<contains_less, KT>::value)
+                return sortedContains(key);
+            else
+                return false;
+        }
+
+        membership_type structure() const { return structure_; }
+        bool bloomPrefilter() const { return !bloom_.empty(); }
+
+    private:
+        static constexpr bool is_bitmap_key = std::is_integral_v<KT> && !std::is_same_v<KT, bool>;
+
+        static auto toUnsigned(const KT &key)
+        {
+            return static_cast<std::make_unsigned_t<std::conditional_t<is_bitmap_key, KT, int>>>(key);
+        }
+
+        void buildBitmap(const std::vector<KT> &keys, KT min, uint64_t range)
+        {
+            bitmap_min_ = min;
+            bitmap_max_ = *std::max_element(keys.begin(), keys.end());
+            bitmap_.assign(range / 64 + 1, 0);
+
+            for(const auto &key : keys)
+            {
+                auto bit = static_cast<uint64_t>(toUnsigned(key) - toUnsigned(min));
+                bitmap_[bit >> 6] |= uint64_t{1} << (bit & 63);
+            }
+
+            structure_ = membership_type::bitmap;
+        }
+
+        // linear probing in a power of two table at most half full
+        void buildHash(const std::vector<KT> &keys)
+        {
+            size_t capacity = 8;
+            while(capacity < keys.size() * 2)
+                capacity *= 2;
+
+            hash_slots_.assign(capacity, KT{});
+            hash_used_.assign(capacity, 0);
+            hash_mask_ = capacity - 1;
+
+            for(const auto &key : keys)
+            {
+                auto slot = mixHash(std::hash<KT>{}(key)) & hash_mask_;
+                while(hash_used_[slot] && !(hash_slots_[slot] == key))
+                    slot = (slot + 1) & hash_mask_;
+
+                hash_slots_[slot] = key;
+                hash_used_[slot] = 1;
+            }
+
+            structure_ = membership_type::flat_hash;
+        }
+
+        bool hashContains(const KT &key) const
+        {
+            auto slot = mixHash(std::hash<KT>{}(key)) & hash_mask_;
+            while(hash_used_[slot])
+            {
+                if(hash_slots_[slot] == key)
+                    return true;
+
+                slot = (slot + 1) & hash_mask_;
+            }
+
+            return false;
+        }
+
+        // lower bound without a branch on the comparison, the loop length
+        // depends only on the number of keys
+        bool sortedContains(const KT &key) const
+        {
+            if(sorted_keys_.empty())
+                return false;
+
+            const KT *base = sorted_keys_.data();
+            size_t length = sorted_keys_.size();
+            while(length > 1)
+            {
+                auto half = length / 2;
+                base += (base[half - 1] < key) * half;
+                length -= half;
+            }
+
+            return !(*base < key) && !(key < *base);
+        }
+
+        // about 10 bits a key and 4 probes, a false positive rate of about 1%
+        void buildBloom(const std::vector<KT> &keys)
+        {
+            size_t bits = 64;
+            while(bits < keys.size() * 10)
+                bits *= 2;
+
+            bloom_.assign(bits / 64, 0);
+            bloom_mask_ = bits - 1;
+
+            for(const auto &key : keys)
+            {
+                auto hash = mixHash(std::hash<KT>{}(key));
+                for(size_t probe = 0; probe < bloom_probes_; ++probe)
+                {
+                    auto bit = bloomBit(hash, probe);
+                    bloom_[bit >> 6] |= uint64_t{1} << (bit & 63);
+                }
+            }
+        }
+
+        bool bloomContains(size_t hash) const
+        {
+            for(size_t probe = 0; probe < bloom_probes_; ++probe)
+            {
+                auto bit = bloomBit(hash, probe);
+                if(!((bloom_[bit >> 6] >> (bit & 63)) & 1))
+                    return false;
+            }
+
+            return true;
+        }
+
+        // double hashing, the probes from the two halves of the hash
+        size_t bloomBit(size_t hash, size_t probe) const
+        {
+            auto high = (static_cast<uint64_t>(hash) >> 32) | 1;
+            return static_cast<size_t>((static_cast<uint64_t>(hash) + probe * high) & bloom_mask_);
+        }
+
+        static constexpr size_t bloom_probes_ = 4;
+
+        PT projection_;
+        bool negate_;
+        membership_type structure_ = membership_type::flat_hash;
+
+        std::vector<KT> sorted_keys_;
+
+        std::vector<KT> hash_slots_;
+        std::vector<uint8_t> hash_used_;
+        size_t hash_mask_ = 0;
+
+        std::vector<uint64_t> bitmap_;
+        KT bitmap_min_{};
+        KT bitmap_max_{};
+
+        std::vector<uint64_t> bloom_;
+        size_t bloom_mask_ = 0;
+    };
+
+    // whereIn operation
+    // keep the elements whose projected key is in the given keys, a where
+    // with a keyMembership predicate
+    template<typename PT, typename KT>
+    struct whereIn : where<keyMembership<PT, KT>>
+    {
+        template<typename KC>
+        whereIn(PT projection, const KC &keys, bool bloom_prefilter = false)
+            :where<keyMembership<PT, KT>>(keyMembership<PT, KT>{std::move(projection), 
+                                          std::begin(keys), std::end(keys), false, bloom_prefilter})
+        { }
+    };
+
+    template<typename PT, typename KC>
+    whereIn(PT, const KC&, bool = false) -> whereIn<PT, typename KC::value_type>;
+
+    // whereNotIn operation
+    // keep the elements whose projected key is not in the given keys
+    template<typename PT, typename KT>
+    struct whereNotIn : where<keyMembership<PT, KT>>
+    {
+        template<typename KC>
+        whereNotIn(PT projection, const KC &keys, bool bloom_prefilter = false)
+            :where<keyMembership<PT, KT>>(keyMembership<PT, KT>{std::move(projection), 
+                                          std::begin(keys), std::end(keys), true, bloom_prefilter})
+        { }
+    };
+
+    template<typename PT, typename KC>
+    whereNotIn(PT, const KC&, bool = false) -> whereNotIn<PT, typename KC::value_type>;
+
+    // the key bounds of a sortedIndex lookup, a bound not given is unbounded
+    template<typename KT>
+    struct keyBounds
+    {
+        std::optional<KT> lower_;
+        bool lower_inclusive_ = true;
+        std::optional<KT> upper_;
+        bool upper_inclusive_ = true;
+
+        bool operator()(const KT &key) const
+        {
+            if(lower_ && (lower_inclusive_ ? key < *lower_ : !(*lower_ < key)))
+                return false;
+
+            if(upper_ && (upper_inclusive_ ? *upper_ < key : !(key < *upper_)))
+                return false;
+
+            return true;
+        }
+    };
+
+    // where predicate answered by an index. Called with an element it tests
+    // the element like any other where predicate, so it can be used
+    // anywhere, but as the first operation on the index source, read in place
+    // with from{index.source()}, the matching elements are selected by the
+    // index without a scan of all the data.
+    template<typename IT>
+    struct indexLookup
+    {
+        const IT *index_;
+        typename IT::bounds_type bounds_;
+
+        template<typename VT>
+        bool operator()(const VT &value) const
+        {
+            return index_->matches(bounds_, value);
+        }
+
+        // data is the indexed source and the index is current for it
+        template<typename DT>
+        bool current(const DT &data) const
+        {
+            if constexpr(std::is_same_v<DT, typename IT::source_type>)
+                return index_->current(data);
+            else
+                return false;
+        }
+
+        // the matching elements of the index source, added to the results
+        // by append
+        template<typename AT = stageAppend<>>
+        auto lookup(AT &&append = AT{}) const
+        {
+            return index_->select(bounds_, append);
+        }
+    };
+
+    // the source of an index read in place, used as the data of a from,
+    // from{index.source()}, the source is not copied by the from and a first
+    // where lookup of the index copies only the matching elements.
+    template<typename ST>
+    class indexSource
+    {
+    public:
+        using value_type = typename ST::value_type;
+        using const_iterator = typename ST::const_iterator;
+        using iterator = const_iterator;
+
+        explicit indexSource(const ST &source)
+            :source_(&source)
+        { }
+
+        const ST &container() const { return *source_; }
+
+        const_iterator begin() const { return source_->begin(); }
+        const_iterator end() const { return source_->end(); }
+        size_t size() const { return source_->size(); }
+        bool empty() const { return source_->empty(); }
+
+    private:
+        const ST *source_;
+    };
+
+    // copies of the elements of source at the given positions, added to
+    // the results by append
+    template<typename ST, typename AT>
+    ST gatherPositions(const std::vector<size_t> &positions, const ST &source, AT &append)
+    {
+        ST results;
+        append.reserve(results, positions.size());
+
+        for(auto position : positions)
+            append(results, source[position]);
+
+        return results;
+    }
+
+    // the key range lookups of an index, IT the index type giving a lookup
+    // for keyBounds
+    template<typename IT, typename KT>
+    struct keyRangeLookups
+    {
+        auto equalTo(const KT &key) const { return index().lookup({key, true, key, true}); }
+        auto between(const KT &lower, const KT &upper) const { return index().lookup({lower, true, upper, true}); }
+        auto lessThan(const KT &key) const { return index().lookup({std::nullopt, true, key, false}); }
+        auto atMost(const KT &key) const { return index().lookup({std::nullopt, true, key, true}); }
+        auto greaterThan(const KT &key) const { return index().lookup({key, false, std::nullopt, true}); }
+        auto atLeast(const KT &key) const { return index().lookup({key, true, std::nullopt, true}); }
+
+    private:
+        const IT &index() const { return static_cast<const IT&>(*this); }
+    };
+
+    // sortedIndex
+    // secondary index of a random access source ordered by the key the
+    // projection gives each element, equality and range lookups are answered
+    // by binary search. The index holds the source by reference and is valid
+    // while the source is unchanged, elements appended to the source are
+    // added with update, any other change to the source needs a rebuild.
+    template<typename ST, typename PT>
+    class sortedIndex : public keyRangeLookups<sortedIndex<ST, PT>,
+                                               std::decay_t<std::invoke_result_t<const PT&, const typename ST::value_type&>>>
+    {
+    public:
+        using source_type = ST;
+        using value_type = typename ST::value_type;
+        using key_type = std::decay_t<std::invoke_result_t<const PT&, const value_type&>>;
+        using bounds_type = keyBounds<key_type>;
+
+        sortedIndex(const ST &source, PT projection)
+            :source_(&source), projection_(std::move(projection))
+        {
+            update();
+        }
+
+        // index all the elements of the source
+        void rebuild()
+        {
+            keys_.clear();
+            indexed_size_ = 0;
+            update();
+        }
+
+        // index the elements appended to the source since the last update,
+        // the new keys are sorted and merged with the existing keys
+        void update()
+        {
+            if(source_->size() < indexed_size_)
+            {
+                rebuild();
+                return;
+            }
+
+            auto key_less = [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; };
+
+            auto middle = keys_.size();
+            for(auto position = indexed_size_; position < source_->size(); ++position)
+                keys_.emplace_back(projection_((*source_)[position]), position);
+
+            // stable so equal keys stay in source order
+            std::stable_sort(keys_.begin() + middle, keys_.end(), key_less);
+            std::inplace_merge(keys_.begin(), keys_.begin() + middle, keys_.end(), key_less);
+
+            indexed_size_ = source_->size();
+        }
+
+        size_t size() const { return indexed_size_; }
+
+        bool current(size_t size) const
+        {
+            return size == indexed_size_ && source_->size() == indexed_size_;
+        }
+
+        // data is the indexed source, not a copy of it, and is indexed in full
+        bool current(const ST &data) const
+        {
+            return &data == source_ && current(data.size());
+        }
+
+        // the source read in place, for from{index.source()}
+        indexSource<ST> source() const { return indexSource<ST>{*source_}; }
+
+        // where clause lookup for the key bounds, equalTo, between, lessThan,
+        // atMost, greaterThan and atLeast give the bounds
+        indexLookup<sortedIndex> lookup(bounds_type bounds) const
+        {
+            return {this, std::move(bounds)};
+        }
+
+        template<typename VT>
+        bool matches(const bounds_type &bounds, const VT &value) const
+        {
+            return bounds(projection_(value));
+        }
+
+        std::vector<size_t> positions(const bounds_type &bounds) const
+        {
+            auto first = keys_.begin();
+            auto last = keys_.end();
+
+            if(bounds.lower_)
+            {
+                first = bounds.lower_inclusive_ ?
+                        std::lower_bound(first, last, *bounds.lower_, keyBefore()) :
+                        std::upper_bound(first, last, *bounds.lower_, valueBefore());
+            }
+
+            if(bounds.upper_)
+            {
+                last = bounds.upper_inclusive_ ?
+                       std::upper_bound(first, last, *bounds.upper_, valueBefore()) :
+                       std::lower_bound(first, last, *bounds.upper_, keyBefore());
+            }
+
+            std::vector<size_t> results;
+            results.reserve(std::distance(first, last));
+            for(; first != last; ++first)
+                results.push_back(first->second);
+
+            // a range of keys is in key order, put back in source order
+            if(!std::is_sorted(results.begin(), results.end()))
+                std::sort(results.begin(), results.end());
+
+            return results;
+        }
+
+        template<typename AT>
+        ST select(const bounds_type &bounds, AT &append) const
+        {
+            return gatherPositions(positions(bounds), *source_, append);
+        }
+
+    private:
+        static auto keyBefore() { return [](const auto &entry, const key_type &key) { return entry.first < key; }; }
+        static auto valueBefore() { return [](const key_type &key, const auto &entry) { return key < entry.first; }; }
+
+        const ST *source_;
+        PT projection_;
+        std::vector<std::pair<key_type, size_t>> keys_;
+        size_t indexed_size_ = 0;
+    };
+
+    // hashIndex
+    // secondary index of a random access source hashed on the key the
+    // projection gives each element, equality lookups are answered by a hash
+    // probe. Valid while the source is unchanged, as for sortedIndex.
+    template<typename ST, typename PT>
+    class hashIndex
+    {
+    public:
+        using source_type = ST;
+        using value_type = typename ST::value_type;
+        using key_type = std::decay_t<std::invoke_result_t<const PT&, const value_type&>>;
+        using bounds_type = key_type;
+
+        hashIndex(const ST &source, PT projection)
+            :source_(&source), projection_(std::move(projection))
+        {
+            update();
+        }
+
+        // index all the elements of the source
+        void rebuild()
+        {
+            positions_.clear();
+            indexed_size_ = 0;
+            update();
+        }
+
+        // index the elements appended to the source since the last update
+        void update()
+        {
+            if(source_->size() < indexed_size_)
+            {
+                rebuild();
+                return;
+            }
+
+            for(auto position = indexed_size_; position < source_->size(); ++position)
+                positions_[projection_((*source_)[position])].push_back(position);
+
+            indexed_size_ = source_->size();
+        }
+
+        size_t size() const { return indexed_size_; }
+
+        bool current(size_t size) const
+        {
+            return size == indexed_size_ && source_->size() == indexed_size_;
+        }
+
+        // data is the indexed source, not a copy of it, and is indexed in full
+        bool current(const ST &data) const
+        {
+            return &data == source_ && current(data.size());
+        }
+
+        // the source read in place, for from{index.source()}
+        indexSource<ST> source() const { return indexSource<ST>{*source_}; }
+
+        // lookup for where clauses
+        indexLookup<hashIndex> equalTo(const key_type &key) const { return {this, key}; }
+
+        template<typename VT>
+        bool matches(const key_type &key, const VT &value) const
+        {
+            return projection_(value) == key;
+        }
+
+        // positions of an equal key are held in source order
+        std::vector<size_t> positions(const key_type &key) const
+        {
+            auto found = positions_.find(key);
+            return found == positions_.end() ? std::vector<size_t>{} : found->second;
+        }
+
+        template<typename AT>
+        ST select(const key_type &key, AT &append) const
+        {
+            return gatherPositions(positions(key), *source_, append);
+        }
+
+    private:
+        const ST *source_;
+        PT projection_;
+        std::unordered_map<key_type, std::vector<size_t>> positions_;
+        size_t indexed_size_ = 0;
+    };
+
+    // zoneMap
+    // min and max of the key the projection gives each element, kept for each
+    // block of block_size elements of a random access source. A where with a
+    // key range lookup skips the blocks whose min and max can not match and
+    // tests only the elements of the other blocks, for sources ordered, or
+    // mostly ordered, by the key (time ordered logs) most blocks are skipped.
+    // Valid while the source is unchanged, elements appended to the source
+    // are added with update.
+    template<typename ST, typename PT>
+    class zoneMap : public keyRangeLookups<zoneMap<ST, PT>,
+                                           std::decay_t<std::invoke_result_t<const PT&, const typename ST::value_type&>>>
+    {
+    public:
+        using source_type = ST;
+        using value_type = typename ST::value_type;
+        using key_type = std::decay_t<std::invoke_result_t<const PT&, const value_type&>>;
+        using bounds_type = keyBounds<key_type>;
+
+        zoneMap(const ST &source, PT projection, size_t block_size = 4096)
+            :source_(&source), projection_(std::move(projection)), block_size_(std::max<size_t>(1, block_size))
+        {
+            update();
+        }
+
+        // the min and max of all the blocks of the source
+        void rebuild()
+        {
+            zones_.clear();
+            indexed_size_ = 0;
+            update();
+        }
+
+        // add the elements appended to the source since the last update, the
+        // last block, if it was not full, is extended
+        void update()
+        {
+            if(source_->size() < indexed_size_)
+            {
+                rebuild();
+                return;
+            }
+
+            for(auto position = indexed_size_; position < source_->size(); ++position)
+            {
+                auto key = projection_((*source_)[position]);
+
+                if(position % block_size_ == 0)
+                    zones_.emplace_back(key, key);
+                else
+                {
+                    auto &zone = zones_.back();
+                    if(key < zone.first)
+                        zone.first = key;
+                    if(zone.second < key)
+                        zone.second = key;
+                }
+            }
+
+            indexed_size_ = source_->size();
+        }
+
+        size_t size() const { return indexed_size_; }
+        size_t blockSize() const { return block_size_; }
+        size_t blocks() const { return zones_.size(); }
+
+        bool current(size_t size) const
+        {
+            return size == indexed_size_ && source_->size() == indexed_size_;
+        }
+
+        // data is the indexed source, not a copy of it, and is indexed in full
+        bool current(const ST &data) const
+        {
+            return &data == source_ && current(data.size());
+        }
+
+        // the source read in place, for from{index.source()}
+        indexSource<ST> source() const { return indexSource<ST>{*source_}; }
+
+        // where clause lookup for the key bounds
+        indexLookup<zoneMap> lookup(bounds_type bounds) const
+        {
+            return {this, std::move(bounds)};
+        }
+
+        template<typename VT>
+        bool matches(const bounds_type &bounds, const VT &value) const
+        {
+            return bounds(projection_(value));
+        }
+
+        // the block with the given min and max may hold a key in the bounds
+        bool mayMatch(const bounds_type &bounds, const std::pair<key_type, key_type> &zone) const
+        {
+            if(bounds.lower_ && (bounds.lower_inclusive_ ? zone.second < *bounds.lower_ : !(*bounds.lower_ < zone.second)))
+                return false;
+
+            if(bounds.upper_ && (bounds.upper_inclusive_ ? *bounds.upper_ < zone.first : !(zone.first < *bounds.upper_)))
+                return false;
+
+            return true;
+        }
+
+        // the number of blocks a lookup for the bounds has to scan
+        size_t scannedBlocks(const bounds_type &bounds) const
+        {
+            return std::count_if(zones_.begin(), zones_.end(),
+                                 [this, &bounds](const auto &zone) { return mayMatch(bounds, zone); });
+        }
+
+        // copies of the matching elements, added to the results by append,
+        // only the blocks that may match are read from the source
+        template<typename AT>
+        ST select(const bounds_type &bounds, AT &append) const
+        {
+            ST results;
+
+            for(size_t block = 0; block < zones_.size(); ++block)
+            {
+                if(!mayMatch(bounds, zones_[block]))
+                    continue;
+
+                auto first = source_->begin() + block * block_size_;
+                auto last = source_->begin() + std::min(source_->size(), (block + 1) * block_size_);
+
+                // the whole block matches, no element test needed
+                bool whole_block = bounds(zones_[block].first) && bounds(zones_[block].second);
+                for(; first != last; ++first)
+                {
+                    if(whole_block || bounds(projection_(*first)))
+                        append(results, *first);
+                }
+            }
+
+            return results;
+        }
+
+    private:
+        const ST *source_;
+        PT projection_;
+        size_t block_size_;
+        std::vector<std::pair<key_type, key_type>> zones_;
+        size_t indexed_size_ = 0;
+    };
+
+    // rawSerializer
+    // writes and reads the elements of an external sort as their raw bytes,
+    // only for trivially copyable types. Other types need a serializer with the
+    // same write and read methods.
+    struct rawSerializer
+    {
+        template<typename VT>
+        void write(std::ostream &out, const VT &value) const
+        {
+            static_assert(std::is_trivially_copyable_v<VT>,
+                    "linqcpp - externalSort of a type that is not trivially copyable needs a serializer");
+
+            out.write(reinterpret_cast<const char *>(&value), sizeof(VT));
+        }
+
+        // returns false at the end of the input
+        template<typename VT>
+        bool read(std::istream &in, VT &value) const
+        {
+            return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(VT)));
+        }
+    };
+
+    // externalSort
+    // sort data that does not fit in memory, the input is read in runs that
+    // hold at most memory_budget bytes, the storage of the run and the heap
+    // storage the elements own (as estimatedAllocatedBytes counts it), each
+    // run is sorted and written to a temporary file in temp_directory and the
+    // runs are then merged into the output. When there are more than
+    // merge_fan_in runs they are merged in groups first so only merge_fan_in
+    // files are open at a time. The temporary files are removed when the sort
+    // finishes or fails. The elements must be default constructable and
+    // written and read by the serializer.
+    //
+    // A utility rather than an operation, sort streams from any input
+    // iterator into any output iterator so neither has to fit in memory.
+    template<typename ST = rawSerializer>
+    struct externalSort
+    {
+        size_t memory_budget_;
+        std::filesystem::path temp_directory_;
+        ST serializer_;
+        size_t merge_fan_in_ = 64;
+
+        externalSort(size_t memory_budget,
+                     std::filesystem::path temp_directory = std::filesystem::temp_directory_path(),
+                     ST serializer = ST{})
+            :memory_budget_(memory_budget),
+             temp_directory_(std::move(temp_directory)),
+             serializer_(std::move(serializer))
+        { }
+
+        // sort the input range into out using compare, returns the output
+        // iterator past the last element written
+        template<typename IT, typename OT, typename CT>
+        OT sort(IT first, IT last, OT out, CT compare)
+        {
+            using value_type = typename std::iterator_traits<IT>::value_type;
+
+            runFiles runs{temp_directory_};
+
+            std::vector<value_type> run;
+            size_t owned_bytes = 0;
+            for(; first != last; ++first)
+            {
+                const value_type &value = *first;
+                auto value_bytes = ownedBytes(value);
+
+                // a run holds at least one element
+                if(!run.empty() && bytesToAppend(run) + owned_bytes + value_bytes > memory_budget_)
+                {
+                    writeRun(runs, run, compare);
+                    run.clear();
+                    owned_bytes = 0;
+                }
+
+                makeRoomToAppend(run);
+                run.push_back(value);
+                owned_bytes += value_bytes;
+            }
+
+            // everything fitted in the budget, no need to use the disk
+            if(runs.files_.empty())
+            {
+                std::sort(run.begin(), run.end(), compare);
+                return std::move(run.begin(), run.end(), out);
+            }
+
+            if(!run.empty())
+                writeRun(runs, run, compare);
+
+            std::vector<value_type>{}.swap(run);
+
+            // merge groups of runs until they can all be merged at once
+            const size_t fan_in = std::max<size_t>(2, merge_fan_in_);
+            while(runs.files_.size() > fan_in)
+            {
+                std::vector<std::filesystem::path> merged_files;
+                for(size_t group = 0; group < runs.files_.size(); group += fan_in)
+                {
+                    auto group_end = std::min(runs.files_.size(), group + fan_in);
+                    auto file_name = runs.newFile();
+                    std::ofstream file = openOutput(file_name);
+
+                    mergeRuns<value_type>(runs.files_.begin() + group, runs.files_.begin() + group_end, compare,
+                                          [&](value_type &&value) { serializer_.write(file, value); });
+
+                    closeOutput(file, file_name);
+                    merged_files.push_back(std::move(file_name));
+                }
+
+                runs.replace(std::move(merged_files));
+            }
+
+            mergeRuns<value_type>(runs.files_.begin(), runs.files_.end(), compare,
+                                  [&out](value_type &&value) { *out++ = std::move(value); });
+
+            return out;
+        }
+
+    private:
+        // the temporary run files of one sort, removed with the sort
+        struct runFiles
+        {
+            std::filesystem::path directory_;
+            std::vector<std::filesystem::path> files_;
+            std::vector<std::filesystem::path> created_;
+
+            runFiles(std::filesystem::path directory)
+                :directory_(std::move(directory))
+            { }
+
+            ~runFiles()
+            {
+                std::error_code error;
+                for(const auto &file : created_)
+                    std::filesystem::remove(file, error);
+            }
+
+            // name for a new run file unique to this process and sort
+            std::filesystem::path newFile()
+            {
+                static std::atomic<unsigned long long> sort_count{0};
+                static const auto process_id = std::random_device{}();
+
+                auto file = directory_ / ("linqcpp_sort_" + std::to_string(process_id) + "_" +
+                                          std::to_string(sort_count++) + ".run");
+                created_.push_back(file);
+                return file;
+            }
+
+            // the current runs have been merged into the given runs
+            void replace(std::vector<std::filesystem::path> merged_files)
+            {
+                std::error_code error;
+                for(const auto &file : files_)
+                    std::filesystem::remove(file, error);
+
+                files_ = std::move(merged_files);
+            }
+        };
+
+        std::ofstream openOutput(const std::filesystem::path &file_name)
+        {
+            std::ofstream file{file_name, std::ios::binary | std::ios::trunc};
+            if(!file)
+                throw std::runtime_error("linqcpp - externalSort unable to create " + file_name.string());
+
+            return file;
+        }
+
+        void closeOutput(std::ofstream &file, const std::filesystem::path &file_name)
+        {
+            file.close();
+            if(!file)
+                throw std::runtime_error("linqcpp - externalSort unable to write " + file_name.string());
+        }
+
+        // sort the run and write it to a new run file
+        template<typename VT, typename CT>
+        void writeRun(runFiles &runs, std::vector<VT> &run, CT &compare)
+        {
+            std::sort(run.begin(), run.end(), compare);
+
+            auto file_name = runs.newFile();
+            std::ofstream file = openOutput(file_name);
+            for(const auto &value : run)
+                serializer_.write(file, value);
+
+            closeOutput(file, file_name);
+            runs.files_.push_back(std::move(file_name));
+        }
+
+        // k way merge of the sorted run files passing each element in order to
+        // emit. A heap holds the runs ordered by their current element, ties
+        // are taken from the earlier run.
+        template<typename VT, typename FT, typename CT, typename ET>
+        void mergeRuns(FT first_file, FT last_file, CT &compare, ET emit)
+        {
+            std::vector<std::ifstream> inputs;
+            std::vector<VT> heads(std::distance(first_file, last_file));
+            std::vector<size_t> heap;
+
+            for(auto file = first_file; file != last_file; ++file)
+            {
+                inputs.emplace_back(*file, std::ios::binary);
+                if(!inputs.back())
+                    throw std::runtime_error("linqcpp - externalSort unable to read " + file->string());
+
+                if(serializer_.read(inputs.back(), heads[inputs.size() - 1]))
+                    heap.push_back(inputs.size() - 1);
+            }
+
+            auto after = [&](size_t lhs, size_t rhs) {
+                if(compare(heads[rhs], heads[lhs]))
+                    return true;
+
+                return !compare(heads[lhs], heads[rhs]) && rhs < lhs;
+            };
+
+            std::make_heap(heap.begin(), heap.end(), after);
+            while(!heap.empty())
+            {
+                std::pop_heap(heap.begin(), heap.end(), after);
+                auto run = heap.back();
+
+                emit(std::move(heads[run]));
+
+                if(serializer_.read(inputs[run], heads[run]))
+                    std::push_heap(heap.begin(), heap.end(), after);
+                else
+                    heap.pop_back();
+            }
+        }
+    };
+
+    // sort the chunks of the range then merge the sorted runs pairwise,
+    // checking the cancellation operation after each chunk sort and merge
+    template<typename IT, typename CP, typename CT>
+    void cancellableSort(IT first, IT last, CP compare, const CT &cancel_op)
+    {
+        auto size = static_cast<size_t>(std::distance(first, last));
+
+        processChunks(first, last, cancel_op, [&compare](auto chunk_first, auto chunk_last) {
+                          std::sort(chunk_first, chunk_last, compare);
+                      });
+
+        for(size_t width = cancelWhen::chunk_size_; width < size; width *= 2)
+        {
+            for(size_t start = 0; start + width < size; start += 2 * width)
+            {
+                std::inplace_merge(first + start, first + start + width,
+                                   first + std::min(start + 2 * width, size), compare);
+                cancel_op.check();
+            }
+        }
+    }
+
+    // operations that neither filter, reorder nor change the elements passed
+    // from the stage before them to the stage after them
+    constexpr bool passesElementsThrough(std::string_view name)
+    {
+        return name == extract_name() || name == from_name() ||
+               name == profile_name() || name == to_collection_name() ||
+               name == cancellation_name() || name == memory_budget_name();
+    }
+
+    // compile time check that a skip or take follows the orderBy with only
+    // operations that leave the elements unchanged between them, so only the
+    // positions they keep need to be ordered
+    template<typename TT>
+    constexpr bool selectionFollowsOrdering()
+    {
+        constexpr auto names = tupleOperations<TT>::names_;
+        constexpr auto order_by_index = tupleOperations<TT>::index(order_by_name);
+        constexpr auto skip_index = tupleOperations<TT>::index(skip_name);
+        constexpr auto take_index = tupleOperations<TT>::index(take_name);
+
+        constexpr auto count = names.size();
+        if(order_by_index == count || (skip_index == count && take_index == count))
+            return false;
+
+        // each given skip and take must be after the orderBy
+        if((skip_index != count && skip_index < order_by_index) ||
+           (take_index != count && take_index < order_by_index))
+            return false;
+
+        auto last = skip_index == count ? take_index : (take_index == count ? skip_index : std::max(skip_index, take_index));
+
+        for(auto index = order_by_index + 1; index < last; ++index)
+        {
+            if(!passesElementsThrough(names[index]) &&
+               names[index] != skip_name() && names[index] != take_name())
+                return false;
+        }
+
+        return true;
+    }
+
+    // compile time check that a take follows the skip with only operations
+    // that leave the elements unchanged between them, so the skip can keep
+    // just the positions the take keeps
+    template<typename TT>
+    constexpr bool takeFollowsSkip()
+    {
+        constexpr auto names = tupleOperations<TT>::names_;
+        constexpr auto skip_index = tupleOperations<TT>::index(skip_name);
+        constexpr auto take_index = tupleOperations<TT>::index(take_name);
+
+        if(skip_index == names.size() || take_index == names.size() || take_index < skip_index)
+            return false;
+
+        for(auto index = skip_index + 1; index < take_index; ++index)
+        {
+            if(!passesElementsThrough(names[index]))
+                return false;
+        }
+
+        return true;
+    }
+
+    // the positions [first, last) of the given number of elements kept by
+    // the skip and take operations, applied in the order given
+    template<typename TT>
+    std::pair<size_t, size_t> selectionWindow(const TT &tuple_pack, size_t size)
+    {
+        constexpr auto skip_index = tupleOperations<TT>::index(skip_name);
+        constexpr auto take_index = tupleOperations<TT>::index(take_name);
+        constexpr auto count = std::tuple_size<TT>{};
+
+        size_t first = 0;
+        size_t last = size;
+
+        if constexpr(skip_index < count)
+            first = std::min<size_t>(std::get<skip_index>(tuple_pack).skip_number_, size);
+
+        if constexpr(take_index < count)
+        {
+            size_t take_number = std::get<take_index>(tuple_pack).take_number_;
+
+            // a take before the skip bounds the elements the skip is from
+            if constexpr(take_index < skip_index && skip_index < count)
+                last = std::max(first, std::min(take_number, size));
+            else
+                last = first + std::min(take_number, size - first);
+        }
+
+        return {first, last};
+    }
+
+    // orderBy operation
+    // order the data using the order_by_operation predicate or if the results
+    // container is a map or set (or a flat map or set) use the predicate as the
+    // comparison predicate
+    template<typename OT = defaultIndicator>
+    struct orderBy
+    {
+        static constexpr auto operation = order_by_name();
+
+        OT order_by_operation_;
+        orderBy(OT order_by_op = defaultIndicator{})
+            :order_by_operation_(std::move(order_by_op))
+        { }
+
+        // process the ordering
+        // compile time search the tuple_data_pack for the results container to
+        // decide if the container should be sorted or if container is map or
+        // set type then do not sort here as order_by_operation predicate will
+        // be used by as the comparison predicate
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto container_op = findOperationFromTuple(to_collection_name, tuple_data_pack,
+                                                      std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            // makes no sense to order if results container is an unordered type
+            static_assert(!(container_op.container_type == as_unordered_map() ||
+                            container_op.container_type == as_unordered_set() ||
+                            container_op.container_type == as_flat_hash_map() ||
+                            container_op.container_type == as_flat_hash_set()),
+                            "Cannot have ordered by operations for unordered containers");
+
+            // the data is sorted in place which needs no more memory than it holds
+            if constexpr(container_op.container_type != as_map() &&
+                         container_op.container_type != as_set() &&
+                         container_op.container_type != as_flat_map() &&
+                         container_op.container_type != as_flat_set())
+            {
+                // if container has its own sort method ie list then use that
+                if constexpr(std::experimental::is_detected<contains_sort, DT>::value)
+                {
+                    // if sorting predicate is not supplied, use std form of sort
+                    if constexpr(std::experimental::is_detected<pred_type, OT>::value)
+                        data.sort();
+                    else
+                        data.sort(order_by_operation_); // else use the supplied predicate
+                }
+                // a following skip or take only keeps a window of the ordered
+                // data, select the window and order only that
+                else if constexpr(selectionFollowsOrdering<TT>())
+                {
+                    auto [first, last] = selectionWindow(tuple_data_pack, data.size());
+
+                    auto compare = [this](const auto &lhs, const auto &rhs) {
+                        if constexpr(std::experimental::is_detected<pred_type, OT>::value)
+                            return lhs < rhs;
+                        else
+                            return order_by_operation_(lhs, rhs);
+                    };
+
+                    if(first < last)
+                    {
+                        auto first_itr = std::next(data.begin(), first);
+                        auto last_itr = std::next(data.begin(), last);
+
+                        if(first > 0)
+                            std::nth_element(data.begin(), first_itr, data.end(), compare);
+
+                        if(last_itr == data.end())
+                            std::sort(first_itr, last_itr, compare);
+                        else
+                            std::partial_sort(first_itr, last_itr, data.end(), compare);
+                    }
+                }
+                // sort in chunks so the cancellation can be checked
+                else if constexpr(decltype(findOperationFromTuple(cancellation_name, tuple_data_pack,
+                                           std::make_index_sequence<std::tuple_size<TT>{}>{}))::operation != default_indicator_name())
+                {
+                    auto cancel_op = findOperationFromTuple(cancellation_name, tuple_data_pack,
+                                                            std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+                    if constexpr(std::experimental::is_detected<pred_type, OT>::value)
+                        cancellableSort(data.begin(), data.end(), std::less<>{}, cancel_op);
+                    else
+                        cancellableSort(data.begin(), data.end(), order_by_operation_, cancel_op);
+                }
+                else // container doesn't have its own sorting method
+                {
+                    if constexpr(std::experimental::is_detected<pred_type, OT>::value)
+                        std::sort(data.begin(), data.end());
+                    else
+                        std::sort(data.begin(), data.end(), order_by_operation_);
+                }
+            }
+
+            return std::move(data);
+        }
+
+        // sorted in place
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, [[maybe_unused]] const DT &data) const
+        {
+            return 0;
+        }
+    };
+
+    // compile time check for a key that can be radix sorted, fixed width
+    // integral, enum and floating point keys of up to 64 bits (__int128 is
+    // integral under gnu++17 but wider than the radix keys)
+    template<typename KT>
+    static constexpr bool is_radix_key = ((std::is_integral_v<KT> || std::is_enum_v<KT>) && sizeof(KT) <= 8) ||
+                                         (std::is_floating_point_v<KT> && (sizeof(KT) == 4 || sizeof(KT) == 8));
+
+    // unsigned integer of the given width
+    template<size_t Size>
+    using radix_unsigned_type = std::conditional_t<Size == 1, uint8_t,
+                                std::conditional_t<Size == 2, uint16_t,
+                                std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+
+    // map the key to an unsigned integer of the same width whose unsigned
+    // order is the order of the key
+    template<typename KT>
+    auto radixKey(KT key)
+    {
+        using unsigned_type = radix_unsigned_type<sizeof(KT)>;
+        constexpr auto sign_bit = unsigned_type{1} << (sizeof(KT) * 8 - 1);
+
+        if constexpr(std::is_enum_v<KT>)
+            return radixKey(static_cast<std::underlying_type_t<KT>>(key));
+        else if constexpr(std::is_same_v<KT, bool>)
+            return static_cast<uint8_t>(key);
+        else if constexpr(std::is_floating_point_v<KT>)
+        {
+            // -0.0 compares equal to 0.0 so is given the same bits
+            if(key == KT{0})
+                key = KT{0};
+
+            // negative values have their order reversed by flipping all the
+            // bits, positive values are moved above them by the sign bit
+            unsigned_type bits;
+            std::memcpy(&bits, &key, sizeof(KT));
+            return static_cast<unsigned_type>((bits & sign_bit) ? ~bits : (bits | sign_bit));
+        }
+        else if constexpr(std::is_signed_v<KT>)
+            return static_cast<unsigned_type>(static_cast<unsigned_type>(key) ^ sign_bit);
+        else
+            return static_cast<unsigned_type>(key);
+    }
+
+    // stable LSD radix sort of (key, index) pairs 11 bits at a time, 2048
+    // counts fit in the L1 cache and 64 bit keys need 6 passes rather than 8.
+    // Passes where every key has the same digit are skipped so narrow ranges
+    // of wide keys only pay for the digits that differ.
+    template<typename KT, typename IT>
+    void radixSort(std::vector<std::pair<KT, IT>> &keys)
+    {
+        constexpr size_t digit_bits = 11;
+        constexpr size_t buckets = size_t{1} << digit_bits;
+        constexpr size_t passes = (sizeof(KT) * 8 + digit_bits - 1) / digit_bits;
+
+        auto digit = [](KT key, size_t pass) { return static_cast<size_t>(key >> (pass * digit_bits)) & (buckets - 1); };
+
+        // count every digit of every key in one pass over the keys
+        std::vector<size_t> counts(passes * buckets, 0);
+        for(const auto &key : keys)
+        {
+            for(size_t pass = 0; pass < passes; ++pass)
+                ++counts[pass * buckets + digit(key.first, pass)];
+        }
+
+        std::vector<std::pair<KT, IT>> buffer(keys.size());
+        for(size_t pass = 0; pass < passes; ++pass)
+        {
+            auto *count = &counts[pass * buckets];
+            if(*std::max_element(count, count + buckets) == keys.size())
+                continue;
+
+            // bucket counts to bucket start positions
+            size_t position = 0;
+            for(size_t bucket = 0; bucket < buckets; ++bucket)
+                position += std::exchange(count[bucket], position);
+
+            for(const auto &key : keys)
+                buffer[count[digit(key.first, pass)]++] = key;
+
+            keys.swap(buffer);
+        }
+    }
+
+    // hint that the given address will be read soon
+    inline void prefetch([[maybe_unused]] const void *address)
+    {
+    #if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+    #endif
+    }
+
+    // compile time check for the key comparisons that a radix sort can
+    // replace, ascending and descending
+    template<typename CT, typename KT>
+    static constexpr bool is_ascending_compare = std::is_same_v<CT, std::less<>> || std::is_same_v<CT, std::less<KT>>;
+
+    template<typename CT, typename KT>
+    static constexpr bool is_descending_compare = std::is_same_v<CT, std::greater<>> || std::is_same_v<CT, std::greater<KT>>;
+
+    // a following key of a multi key ordering, the key projection and the
+    // comparison of the keys
+    template<typename PT, typename CT>
+    struct orderingKey
+    {
+        PT projection_;
+        CT key_compare_;
+    };
+
+    // orderByKey operation
+    // order the data by the key the projection gives each element, the keys
+    // are compared with key_compare (operator< by default). Each key is
+    // computed once, so expensive keys (concatenated or lower cased strings)
+    // are not recomputed for every comparison, and the elements are not
+    // swapped during the sort, the (key, index) pairs are sorted and then the
+    // elements are moved into place in one pass. Integral, enum and floating
+    // point keys compared with std::less or std::greater are ordered with a
+    // radix sort, other keys with a comparison sort. The ordering is stable.
+    // Acts as an orderBy, so if the results container is a map or set the
+    // comparison of the projected keys is used as the comparison predicate.
+    //
+    // thenBy and thenByDescending add keys that order elements with equal
+    // leading keys, NT are the following orderingKey's. Only the runs of
+    // elements with equal leading keys are sorted by the following keys.
+    //
+    // As for orderBy, a following skip or take keeps only a window of the
+    // ordered data, the keys of the window are selected and ordered with
+    // ties in source order, and only the elements up to the end of the
+    // window are moved into the results.
+    template<typename PT, typename CT = std::less<>, typename ...NT>
+    struct orderByKey
+    {
+        static constexpr auto operation = order_by_name();
+
+        // compares elements by their projected keys, the keys are compared in
+        // order until one differs
+        struct keyCompare
+        {
+            PT projection_;
+            CT key_compare_;
+            std::tuple<NT...> next_keys_;
+
+            template<typename VT>
+            bool operator()(const VT &lhs, const VT &rhs) const
+            {
+                decltype(auto) lhs_key = projection_(lhs);
+                decltype(auto) rhs_key = projection_(rhs);
+
+                if(key_compare_(lhs_key, rhs_key))
+                    return true;
+
+                if(key_compare_(rhs_key, lhs_key))
+                    return false;
+
+                return compareNextKeys(lhs, rhs);
+            }
+
+            // compare elements by the following keys only, I is the next key
+            // to compare
+            template<size_t I = 0, typename VT>
+            bool compareNextKeys([[maybe_unused]] const VT &lhs, [[maybe_unused]] const VT &rhs) const
+            {
+                if constexpr(I == sizeof...(NT))
+                    return false;
+                else
+                {
+                    const auto &key = std::get<I>(next_keys_);
+                    decltype(auto) lhs_key = key.projection_(lhs);
+                    decltype(auto) rhs_key = key.projection_(rhs);
+
+                    if(key.key_compare_(lhs_key, rhs_key))
+                        return true;
+
+                    if(key.key_compare_(rhs_key, lhs_key))
+                        return false;
+
+                    return compareNextKeys<I + 1>(lhs, rhs);
+                }
+            }
+
+            // the following keys of the element, for the keys to be cached
+            template<typename VT>
+            auto nextKeys([[maybe_unused]] const VT &value) const
+            {
+                return std::apply([&value](const auto& ...keys) { return std::make_tuple(keys.projection_(value)...); },
+                                  next_keys_);
+            }
+
+            // compare the cached following keys of two elements, I is the
+            // next key to compare
+            template<size_t I = 0, typename KT>
+            bool compareCachedKeys([[maybe_unused]] const KT &lhs, [[maybe_unused]] const KT &rhs) const
+            {
+                if constexpr(I == sizeof...(NT))
+                    return false;
+                else
+                {
+                    const auto &key_compare = std::get<I>(next_keys_).key_compare_;
+
+                    if(key_compare(std::get<I>(lhs), std::get<I>(rhs)))
+                        return true;
+
+                    if(key_compare(std::get<I>(rhs), std::get<I>(lhs)))
+                        return false;
+
+                    return compareCachedKeys<I + 1>(lhs, rhs);
+                }
+            }
+        };
+
+        keyCompare order_by_operation_;
+        orderByKey(PT projection, CT key_compare = CT{})
+            :order_by_operation_{std::move(projection), std::move(key_compare), {}}
+        { }
+
+        orderByKey(keyCompare order_by_op)
+            :order_by_operation_(std::move(order_by_op))
+        { }
+
+        // order elements with equal keys by the given key
+        template<typename KT, typename KCT = std::less<>>
+        auto thenBy(KT projection, KCT key_compare = KCT{}) const
+        {
+            using ordering_type = orderByKey<PT, CT, NT..., orderingKey<KT, KCT>>;
+
+            return ordering_type{typename ordering_type::keyCompare{
+                        order_by_operation_.projection_,
+                        order_by_operation_.key_compare_,
+                        std::tuple_cat(order_by_operation_.next_keys_,
+                                       std::make_tuple(orderingKey<KT, KCT>{std::move(projection), 
+                                                                            std::move(key_compare)}))}};
+        }
+
+        // order elements with equal keys by the given key in descending order
+        template<typename KT>
+        auto thenByDescending(KT projection) const
+        {
+            return thenBy(std::move(projection), std::greater<>{});
+        }
+
+        // process the ordering
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            auto container_op = findOperationFromTuple(to_collection_name, tuple_data_pack,
+                                                      std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            // makes no sense to order if results container is an unordered type
+            static_assert(!(container_op.container_type == as_unordered_map() ||
+                            container_op.container_type == as_unordered_set() ||
+                            container_op.container_type == as_flat_hash_map() ||
+                            container_op.container_type == as_flat_hash_set()),
+                            "Cannot have ordered by operations for unordered containers");
+
+            if constexpr(container_op.container_type == as_map() ||
+                         container_op.container_type == as_set() ||
+                         container_op.container_type == as_flat_map() ||
+                         container_op.container_type == as_flat_set())
+                return std::move(data);
+            else if constexpr(!std::is_base_of_v<std::random_access_iterator_tag, 
+                                                 typename std::iterator_traits<typename DT::iterator>::iterator_category>)
+            {
+                // node based container ie list, relink the nodes in key order
+                // so no element is moved
+                std::vector<typename DT::iterator> nodes;
+                nodes.reserve(data.size());
+                for(auto itr = data.begin(); itr != data.end(); ++itr)
+                    nodes.push_back(itr);
+
+                for(auto &key : sortedKeys<size_t>(data))
+                    data.splice(data.end(), data, nodes[key.second]);
+
+                return std::move(data);
+            }
+            else if constexpr(selectionFollowsOrdering<TT>())
+            {
+                auto [first, last] = selectionWindow(tuple_data_pack, data.size());
+                return moveIntoOrder(selectedKeys(data, first, last), std::move(data));
+            }
+            else if(data.size() <= std::numeric_limits<uint32_t>::max())
+                return moveIntoOrder(sortedKeys<uint32_t>(data), std::move(data));
+            else
+                return moveIntoOrder(sortedKeys<size_t>(data), std::move(data));
+        }
+
+        // the (key, position) pairs of the data in key order, the position is
+        // the index of the element. The following keys of a thenBy are
+        // computed once for each element, as the leading key is, and held by
+        // position.
+        template<typename IT, typename DT>
+        auto sortedKeys(DT &data)
+        {
+            using key_type = std::decay_t<decltype(order_by_operation_.projection_(*data.begin()))>;
+
+            std::vector<decltype(order_by_operation_.nextKeys(*data.begin()))> next_keys;
+            if constexpr(sizeof...(NT) > 0)
+            {
+                next_keys.reserve(data.size());
+                for(const auto &value : data)
+                    next_keys.push_back(order_by_operation_.nextKeys(value));
+            }
+
+            if constexpr(is_radix_key<key_type> && (is_ascending_compare<CT, key_type> ||
+                                                    is_descending_compare<CT, key_type>))
+            {
+                using radix_type = decltype(radixKey(std::declval<key_type>()));
+
+                std::vector<std::pair<radix_type, IT>> keys;
+                keys.reserve(data.size());
+
+                IT index = 0;
+                for(const auto &value : data)
+                {
+                    auto key = radixKey(order_by_operation_.projection_(value));
+
+                    // descending order is the ascending order of the
+                    // complemented key, equal keys keep their order
+                    if constexpr(is_descending_compare<CT, key_type>)
+                        key = static_cast<radix_type>(~key);
+
+                    keys.emplace_back(key, index++);
+                }
+
+                radixSort(keys);
+
+                // order the runs of equal leading keys by the following keys
+                if constexpr(sizeof...(NT) > 0)
+                {
+                    for(auto run = keys.begin(); run != keys.end(); )
+                    {
+                        auto run_end = std::find_if(run, keys.end(),
+                                                    [&run](const auto &key) { return key.first != run->first; });
+
+                        if(std::distance(run, run_end) > 1)
+                        {
+                            std::stable_sort(run, run_end, [this, &next_keys](const auto &lhs, const auto &rhs) {
+                                                 return order_by_operation_.compareCachedKeys(next_keys[lhs.second],
+                                                                                              next_keys[rhs.second]);
+                                             });
+                        }
+
+                        run = run_end;
+                    }
+                }
+
+                return keys;
+            }
+            else
+            {
+                std::vector<std::pair<key_type, IT>> keys;
+                keys.reserve(data.size());
+
+                IT index = 0;
+                for(const auto &value : data)
+                    keys.emplace_back(order_by_operation_.projection_(value), index++);
+
+                std::stable_sort(keys.begin(), keys.end(),
+                                 [this, &next_keys](const auto &lhs, const auto &rhs) {
+                                     const auto &key_compare = order_by_operation_.key_compare_;
+
+                                     if(key_compare(lhs.first, rhs.first))
+                                         return true;
+
+                                     if constexpr(sizeof...(NT) == 0)
+                                         return false;
+                                     else
+                                         return !key_compare(rhs.first, lhs.first) &&
+                                                order_by_operation_.compareCachedKeys(next_keys[lhs.second],
+                                                                                      next_keys[rhs.second]);
+                                 });
+                return keys;
+            }
+        }
+
+        // the (key, position) pairs of the first last elements in key order,
+        // of which those from first are ordered, the positions before first
+        // are the elements a skip removes. Equal keys are ordered by their
+        // position so the window is the one a stable sort gives.
+        template<typename DT>
+        auto selectedKeys(DT &data, size_t first, size_t last)
+        {
+            using key_type = std::decay_t<decltype(order_by_operation_.projection_(*data.begin()))>;
+
+            std::vector<decltype(order_by_operation_.nextKeys(*data.begin()))> next_keys;
+            if constexpr(sizeof...(NT) > 0)
+            {
+                next_keys.reserve(data.size());
+                for(const auto &value : data)
+                    next_keys.push_back(order_by_operation_.nextKeys(value));
+            }
+
+            std::vector<std::pair<key_type, size_t>> keys;
+            keys.reserve(data.size());
+
+            size_t index = 0;
+            for(const auto &value : data)
+                keys.emplace_back(order_by_operation_.projection_(value), index++);
+
+            auto compare = [this, &next_keys](const auto &lhs, const auto &rhs) {
+                const auto &key_compare = order_by_operation_.key_compare_;
+
+                if(key_compare(lhs.first, rhs.first))
+                    return true;
+
+                if(key_compare(rhs.first, lhs.first))
+                    return false;
+
+                if constexpr(sizeof...(NT) > 0)
+                {
+                    if(order_by_operation_.compareCachedKeys(next_keys[lhs.second], next_keys[rhs.second]))
+                        return true;
+
+                    if(order_by_operation_.compareCachedKeys(next_keys[rhs.second], next_keys[lhs.second]))
+                        return false;
+                }
+
+                return lhs.second < rhs.second;
+            };
+
+            if(first < last)
+            {
+                if(first > 0)
+                    std::nth_element(keys.begin(), std::next(keys.begin(), first), keys.end(), compare);
+
+                if(last == keys.size())
+                    std::sort(std::next(keys.begin(), first), keys.end(), compare);
+                else
+                    std::partial_sort(std::next(keys.begin(), first), std::next(keys.begin(), last), keys.end(), compare);
+            }
+
+            keys.resize(last);
+            return keys;
+        }
+
+        // move the elements into the order given by the sorted keys
+        template<typename KT, typename DT>
+        DT moveIntoOrder(const KT &sorted_keys, DT &&data)
+        {
+            DT results;
+            if constexpr(std::experimental::is_detected<contains_reserve, DT>::value)
+                results.reserve(sorted_keys.size());
+
+            // the element reads are random so fetch a few ahead
+            constexpr size_t prefetch_distance = 16;
+            for(size_t i = 0; i < sorted_keys.size(); ++i)
+            {
+                if(i + prefetch_distance < sorted_keys.size())
+                    prefetch(&data[sorted_keys[i + prefetch_distance].second]);
+
+                results.push_back(std::move(data[sorted_keys[i].second]));
+            }
+
+            return results;
+        }
+    };
+
+    // erase the elements of data not marked in keep, the elements kept are
+    // moved forward in place and keep their order
+    template<typename DT>
+    void eraseUnmarked(DT &data, const std::vector<bool> &keep)
+    {
+        auto out = data.begin();
+        size_t position = 0;
+        for(auto itr = data.begin(); itr != data.end(); ++itr, ++position)
+        {
+            if(keep[position])
+            {
+                if(out != itr)
+                    *out = std::move(*itr);
+                ++out;
+            }
+        }
+        data.erase(out, data.end());
+    }
+
+    // stable unique, remove duplicates keeping order
+    // unique_hash - hash of the elements that agrees with the unique
+    //               predicate (elements equal by it have equal hashes), when
+    //               not given std::hash of the element is used
+    template<typename UT = defaultIndicator, typename HT = defaultIndicator>
+    struct stableUnique
+    {
+        static constexpr auto operation = stable_unique_name();
+
+        UT unique_predicate_;
+        HT unique_hash_;
+
+        stableUnique(UT unique_pred = defaultIndicator{}, HT unique_hash = defaultIndicator{})
+            :unique_predicate_(std::move(unique_pred)),
+             unique_hash_(std::move(unique_hash))
+        { }
+
+        // process the uniqueness 
+        // tuple_data_pack is unused 
+        // data - remove duplicates from this container
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            using value_type = typename std::decay_t<DT>::value_type;
+
+            // use an unordered_set of pointers to the first of each value to
+            // determine if the value already exists, the elements are not
+            // copied into the set so move only elements can be made unique
+            auto hash = [this](const value_type *value) {
+                            if constexpr(std::experimental::is_detected<pred_type, HT>::value)
+                                return std::hash<value_type>{}(*value);
+                            else
+                                return static_cast<size_t>(unique_hash_(*value));
+                        };
+            auto equal = [this](const value_type *lhs, const value_type *rhs) {
+                             if constexpr(std::experimental::is_detected<pred_type, UT>::value)
+                                 return *lhs == *rhs;
+                             else
+                                 return unique_predicate_(*lhs, *rhs); // predicate provided so use that
+                         };
+
+            std::unordered_set<const value_type*, decltype(hash), decltype(equal)> value_set{data.size(), hash, equal};
+
+            // a list unlinks the duplicate nodes, the nodes kept do not move
+            if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+            {
+                for(auto itr = data.begin(); itr != data.end();)
+                {
+                    if(value_set.insert(std::addressof(*itr)).second)
+                        ++itr;
+                    else
+                        itr = data.erase(itr);
+                }
+            }
+            else
+            {
+                // the elements are moved once all of the duplicates are found
+                std::vector<bool> keep(data.size());
+
+                size_t position = 0;
+                for(const auto &value : data)
+                    keep[position++] = value_set.insert(std::addressof(value)).second;
+
+                value_set.clear();
+                eraseUnmarked(data, keep);
+            }
+
+            return std::move(data);
+        }
+
+        // the hash set of pointers to the unique values seen
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, const DT &data) const
+        {
+            return data.size() * elementAllocatedBytes<std::unordered_set<const typename DT::value_type*>>();
+        }
+
+        // duplicates found through the disk when the hash set does not fit
+        // the memory budget, the (element, position) pairs are sorted by an
+        // externalSort within budget_bytes and the first position of each run
+        // of equal elements is kept. Only for trivially copyable elements
+        // with no uniqueness predicate.
+        template<typename TT, typename DT, typename VT = typename std::decay_t<DT>::value_type,
+                 typename = std::enable_if_t<std::is_trivially_copyable_v<VT> &&
+                                             std::experimental::is_detected<contains_less, VT>::value &&
+                                             std::experimental::is_detected<pred_type, UT>::value>>
+        auto spill([[maybe_unused]] const TT &tuple_data_pack, DT &&data, size_t budget_bytes)
+        {
+            struct positioned
+            {
+                VT value_;
+                size_t position_;
+            };
+
+            // the positions of the data as positioned values
+            struct positionedIterator
+            {
+                using iterator_category [[maybe_unused]] = std::input_iterator_tag;
+                using value_type [[maybe_unused]] = positioned;
+                using difference_type [[maybe_unused]] = std::ptrdiff_t;
+                using pointer [[maybe_unused]] = const positioned*;
+                using reference [[maybe_unused]] = positioned;
+
+                typename std::decay_t<DT>::const_iterator current_;
+                size_t position_;
+
+                positioned operator*() const { return {*current_, position_}; }
+                positionedIterator &operator++() { ++current_; ++position_; return *this; }
+                bool operator==(const positionedIterator &other) const { return current_ == other.current_; }
+                bool operator!=(const positionedIterator &other) const { return current_ != other.current_; }
+            };
+
+            // marks the first position of each run of equal values
+            struct firstOfRun
+            {
+                using iterator_category [[maybe_unused]] = std::output_iterator_tag;
+                using value_type [[maybe_unused]] = void;
+                using difference_type [[maybe_unused]] = std::ptrdiff_t;
+                using pointer [[maybe_unused]] = void;
+                using reference [[maybe_unused]] = void;
+
+                std::vector<bool> *keep_;
+                std::optional<VT> *previous_;
+
+                firstOfRun &operator*() { return *this; }
+                firstOfRun &operator++() { return *this; }
+                firstOfRun operator++(int) { return *this; }
+                firstOfRun &operator=(const positioned &value)
+                {
+                    if(!*previous_ || !(**previous_ == value.value_))
+                    {
+                        (*keep_)[value.position_] = true;
+                        *previous_ = value.value_;
+                    }
+                    return *this;
+                }
+            };
+
+            std::vector<bool> keep(data.size());
+            std::optional<VT> previous;
+
+            externalSort<> sorter{std::max<size_t>(budget_bytes, sizeof(positioned))};
+            sorter.sort(positionedIterator{data.cbegin(), 0}, positionedIterator{data.cend(), data.size()},
+                        firstOfRun{&keep, &previous}, [](const positioned &lhs, const positioned &rhs) {
+                            if(lhs.value_ < rhs.value_)
+                                return true;
+                            if(rhs.value_ < lhs.value_)
+                                return false;
+                            return lhs.position_ < rhs.position_;
+                        });
+
+            // keep the first of each value in place, in the order given
+            eraseUnmarked(data, keep);
+
+            return std::move(data);
+        }
+    };
+
+    // unique operation
+    // for data sets that are already sorted, quicker as there is no need to
+    // keep track of duplicates
+    // unique_hash - not used here as equal elements are adjacent, a
+    //               materializedView uses it to find the equal elements
+    template<typename UT = defaultIndicator, typename HT = defaultIndicator>
+    struct preSortUnique
+    {
+        static constexpr auto operation = pre_sort_unique_name();
+
+        UT unique_predicate_;
+        HT unique_hash_;
+
+        preSortUnique(UT unique_pred = defaultIndicator{}, HT unique_hash = defaultIndicator{})
+            :unique_predicate_(std::move(unique_pred)),
+             unique_hash_(std::move(unique_hash))
+        { }
+
+        // process the uniqueness
+        // tuple_data_pack - unused in this operation
+        // data - remove duplicates from this container
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+
+            if constexpr(std::experimental::is_detected<pred_type, UT>::value)
+            {
+                auto last = std::unique(data.begin(), data.end());
+                data.erase(last, data.end());
+            }
+            else
+            {
+                // use unique predicate if provided
+                auto last = std::unique(data.begin(), data.end(), unique_predicate_);
+                data.erase(last, data.end());
+            }
+
+            return std::move(data);
+        }
+
+        // duplicates are removed in place
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, [[maybe_unused]] const DT &data) const
+        {
+            return 0;
+        }
+    };
+
+    // extract only the top x from given data.
+    struct top
+    {
+        static constexpr auto operation = top_name();
+
+        unsigned int top_number_;
+        top(unsigned int number)
+            :top_number_(number)
+        { }
+
+        // process top operation
+        // tuple_data_pack - not used in this operation
+        // data - take the top data from this container
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            if(data.size() > top_number_)
+            {
+                // a list unlinks the nodes after the top in place
+                if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+                {
+                    data.erase(std::next(data.begin(), top_number_), data.end());
+                    return std::move(data);
+                }
+                else
+                {
+                    DT results;
+                    reserveCollection(results, top_number_);
+
+                    std::move(data.begin(), std::next(data.begin(), top_number_), std::back_inserter(results));
+                    return results;
+                }
+            }
+
+            return std::move(data);
+
+        }
+
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, const DT &data) const
+        {
+            if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+                return 0;
+            else
+                return std::min<size_t>(top_number_, data.size()) * sizeof(typename DT::value_type);
+        }
+    };
+
+    // extract only the bottom x from given data
+    struct bottom
+    {
+        static constexpr auto operation = bottom_name();
+
+        unsigned int bottom_number_;
+        bottom(unsigned int number)
+            :bottom_number_(number)
+        { }
+
+        // process bottom operation
+        // tuple_data_pack - not used in this operation
+        // data - take the bottom from this container
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            if(data.size() > bottom_number_)
+            {
+                auto itr = data.begin();
+                std::advance(itr, data.size() - bottom_number_);
+
+                // a list unlinks the nodes before the bottom in place
+                if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+                {
+                    data.erase(data.begin(), itr);
+                    return std::move(data);
+                }
+                else
+                {
+                    DT results;
+                    reserveCollection(results, bottom_number_);
+
+                    std::move(itr, data.end(), std::back_inserter(results));
+                    return results;
+                }
+            }
+
+            return std::move(data);
+
+        }
+
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, const DT &data) const
+        {
+            if constexpr(std::experimental::is_detected<contains_splice, DT>::value)
+                return 0;
+            else
+                return std::min<size_t>(bottom_number_, data.size()) * sizeof(typename DT::value_type);
+        }
+    };
+
+    // skip the first x of the given data
+    struct skip
+    {
+        static constexpr auto operation = skip_name();
+
+        size_t skip_number_;
+        skip(size_t number)
+            :skip_number_(number)
+        { }
+
+        // process skip operation
+        // tuple_data_pack - to find a take after the skip
+        // data - remove the first skip_number_ from this container
+        template<typename TT, typename DT>
+        auto process(const TT &tuple_data_pack, DT &&data)
+        {
+            // erasing the front of contiguous storage moves every element
+            // after it, so when a take directly follows only the elements it
+            // keeps are moved forward and the rest are erased from the end
+            if constexpr(std::is_base_of_v<std::random_access_iterator_tag,
+                                           typename std::iterator_traits<typename DT::iterator>::iterator_category> &&
+                         std::experimental::is_detected<contains_reserve, DT>::value &&
+                         takeFollowsSkip<TT>())
+            {
+                auto [first, last] = selectionWindow(tuple_data_pack, data.size());
+                if(first > 0)
+                    std::move(std::next(data.begin(), first), std::next(data.begin(), last), data.begin());
+
+                data.erase(std::next(data.begin(), last - first), data.end());
+            }
+            else
+            {
+                auto count = std::min<size_t>(skip_number_, data.size());
+                data.erase(data.begin(), std::next(data.begin(), count));
+            }
+
+            return std::move(data);
+        }
+
+        // elements are erased in place
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, [[maybe_unused]] const DT &data) const
+        {
+            return 0;
+        }
+    };
+
+    // take only the first x of the given data
+    struct take
+    {
+        static constexpr auto operation = take_name();
+
+        size_t take_number_;
+        take(size_t number)
+            :take_number_(number)
+        { }
+
+        // process take operation
+        // tuple_data_pack - not used in this operation
+        // data - keep the first take_number_ of this container
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            if(data.size() > take_number_)
+                data.erase(std::next(data.begin(), take_number_), data.end());
+
+            return std::move(data);
+        }
+
+        // elements are erased in place
+        template<typename TT, typename DT>
+        size_t estimatedBytes([[maybe_unused]] const TT &tuple_data_pack, [[maybe_unused]] const DT &data) const
+        {
+            return 0;
+        }
+    };
+
+
+    // number of the given named operation in the operations list
+    template<typename NT, typename ...TArgs>
+    constexpr auto numberOfNamedOperations(NT op_name, [[maybe_unused]] const TArgs& ...args)
+    {
+        return (0 + ... + (TArgs::operation == op_name() ? 1 : 0));
+    }
+    
+    // statistics of one stage of the processing
+    struct stageStats
+    {
+        std::string_view operation_;
+        std::chrono::nanoseconds duration_{0};
+        size_t elements_in_ = 0;
+        size_t elements_out_ = 0;
+        // storage of the stage results container (capacity times element
+        // size), heap storage owned by the elements is not included
+        size_t bytes_allocated_ = 0;
+        // storage of the stage input and results containers, both held while
+        // the stage runs
+        size_t peak_bytes_ = 0;
+    };
+
+    // statistics of the stages of the processing, in processing order
+    struct pipelineStats
+    {
+        std::vector<stageStats> stages_;
+
+        std::chrono::nanoseconds duration() const
+        {
+            std::chrono::nanoseconds total{0};
+            for(const auto &stage : stages_)
+                total += stage.duration_;
+
+            return total;
+        }
+
+        size_t peakBytes() const
+        {
+            size_t peak = 0;
+            for(const auto &stage : stages_)
+                peak = std::max(peak, stage.peak_bytes_);
+
+            return peak;
+        }
+    };
+
+    // estimate of the storage of a container, its capacity where it has one
+    template<typename DT>
+    size_t containerBytes(const DT &data)
+    {
+        if constexpr(std::experimental::is_detected<contains_reserve, DT>::value)
+            return data.capacity() * sizeof(typename DT::value_type);
+        else
+            return data.size() * sizeof(typename DT::value_type);
+    }
+
+    // profile operation
+    // records the statistics of each stage of the processing into stats, and
+    // calls the callback, if given, with the statistics of each stage as it
+    // completes. Without a profile operation there is no instrumentation code
+    // at all.
+    template<typename CT = defaultIndicator>
+    struct profile
+    {
+        static constexpr auto operation = profile_name();
+
+        pipelineStats *stats_;
+        // called through the operation held for the processing, a stateful
+        // callback keeps its state from stage to stage
+        mutable CT callback_;
+
+        profile(pipelineStats &stats, CT callback = CT{})
+            :stats_(&stats), callback_(std::move(callback))
+        { }
+
+        // start of a processing, the stats of any previous processing are
+        // cleared
+        void start() const
+        {
+            stats_->stages_.clear();
+        }
+
+        template<typename RT>
+        void record(std::string_view operation_name, std::chrono::nanoseconds duration,
+                    size_t elements_in, size_t bytes_in, const RT &results) const
+        {
+            auto bytes_out = containerBytes(results);
+            stats_->stages_.push_back({operation_name, duration, elements_in, results.size(),
+                                       bytes_out, bytes_in + bytes_out});
+
+            if constexpr(!std::experimental::is_detected<pred_type, CT>::value)
+                callback_(stats_->stages_.back());
+        }
+    };
+
+    profile(pipelineStats&) -> profile<defaultIndicator>;
+
+    // run a stage of the processing, the stage produces the results from
+    // data. With a profile operation the time, the sizes and the storage of
+    // the stage are recorded.
+    template<typename TT, typename DT, typename ST>
+    decltype(auto) processStage([[maybe_unused]] const TT &tuple_pack, std::string_view operation_name,
+                      [[maybe_unused]] const DT &data, ST stage)
+    {
+        auto cancel_op = findOperationFromTuple(cancellation_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+        if constexpr(cancel_op.operation != default_indicator_name())
+            cancel_op.check();
+
+        constexpr auto profile_index = tupleOperations<TT>::index(profile_name);
+
+        if constexpr(profile_index == std::tuple_size<TT>{})
+        {
+            return stage();
+        }
+        else
+        {
+            // recorded through the operation in the tuple, not a copy of it
+            const auto &profile_op = std::get<profile_index>(tuple_pack);
+
+            auto elements_in = data.size();
+            auto bytes_in = containerBytes(data);
+
+            auto start = std::chrono::steady_clock::now();
+            decltype(auto) results = stage();
+            profile_op.record(operation_name, std::chrono::steady_clock::now() - start,
+                              elements_in, bytes_in, results);
+
+            return results;
+        }
+    }
+
+    // start of a processing, clear the stats of a profile operation
+    template<typename TT>
+    void startProfile([[maybe_unused]] const TT &tuple_pack)
+    {
+        auto profile_op = findOperationFromTuple(profile_name, tuple_pack,
+                                                 std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+        if constexpr(profile_op.operation != default_indicator_name())
+            profile_op.start();
+    }
+
+    // compile time checks for the memory budget estimate and the spilling of
+    // an operation
+    template<typename T, typename TT, typename DT>
+    using estimated_bytes_type = decltype(std::declval<const T&>().estimatedBytes(std::declval<const TT&>(),
+                                                                                  std::declval<const DT&>()));
+
+    template<typename T, typename TT, typename DT>
+    using spill_type = decltype(std::declval<T&>().spill(std::declval<const TT&>(), std::declval<DT>(), size_t{}));
+
+    // process an operation within the memory budget, if one is given, the
+    // bytes the operation will allocate are estimated and checked before it
+    // runs, by default its results are taken to be a conversion of the whole
+    // of the data
+    template<typename TT, typename FT, typename DT>
+    auto processWithinBudget(const TT &tuple_pack, FT &front, DT &&data)
+    {
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+        if constexpr(budget_op.operation == default_indicator_name())
+        {
+            return front.process(tuple_pack, std::move(data));
+        }
+        else
+        {
+            using results_type = std::decay_t<decltype(front.process(tuple_pack, std::move(data)))>;
+
+            auto input_bytes = estimatedAllocatedBytes(data);
+            size_t stage_bytes = 0;
+            if constexpr(std::experimental::is_detected<estimated_bytes_type, FT, TT, std::decay_t<DT>>::value)
+                stage_bytes = front.estimatedBytes(tuple_pack, data);
+            else
+                stage_bytes = data.size() * elementAllocatedBytes<results_type>();
+
+            if(!budget_op.fits(stage_bytes))
+            {
+                if constexpr(decltype(budget_op)::spill_ &&
+                             std::experimental::is_detected<spill_type, FT, TT, DT&&>::value)
+                {
+                    budget_op.spilled(FT::operation);
+                    auto results = front.spill(tuple_pack, std::move(data), budget_op.available());
+                    budget_op.finished(FT::operation, input_bytes, estimatedAllocatedBytes(data),
+                                       estimatedAllocatedBytes(results), 0);
+                    return results;
+                }
+
+                budget_op.exceeded(FT::operation, stage_bytes);
+            }
+
+            results_type results = front.process(tuple_pack, std::move(data));
+            budget_op.finished(FT::operation, input_bytes, estimatedAllocatedBytes(data), estimatedAllocatedBytes(results), stage_bytes);
+            return results;
+        }
+    }
+
+    // run the extract within the memory budget, if one is given, the results
+    // are estimated from the number of elements extracted
+    template<typename RT, typename TT, typename DT, typename ST>
+    decltype(auto) extractWithinBudget(const TT &tuple_pack, const DT &data, ST stage)
+    {
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+        if constexpr(budget_op.operation == default_indicator_name())
+        {
+            return stage();
+        }
+        else
+        {
+            auto input_bytes = estimatedAllocatedBytes(data);
+            auto stage_bytes = data.size() * elementAllocatedBytes<std::decay_t<RT>>();
+
+            // ordered tree results are put in key order in a buffer first
+            if constexpr(std::experimental::is_detected<contains_key_compare, std::decay_t<RT>>::value &&
+                         !std::experimental::is_detected<flat_storage_type, std::decay_t<RT>>::value)
+                stage_bytes += data.size() * sizeof(typename std::decay_t<RT>::value_type);
+
+            if(!budget_op.fits(stage_bytes))
+                budget_op.exceeded(extract_name(), stage_bytes);
+
+            decltype(auto) results = stage();
+            budget_op.finished(extract_name(), input_bytes, estimatedAllocatedBytes(data), estimatedAllocatedBytes(results), stage_bytes);
+            return results;
+        }
+    }
+
+    // clang8 is currently not correctly ignoring the other branch of the
+    // constexpr if so disabling the warning for now
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wreturn-type"
+    // process the linqcpp operations of the tuple from the I'th on, each
+    // step is instantiated for its index rather than for the rest of the
+    // operations list
+    template<size_t I, typename TT, typename DT>
+    auto processOperationSequence([[maybe_unused]] TT &tuple_pack, DT &&data)
+    {
+        if constexpr (I == std::tuple_size<TT>{})
+        {
+            return std::move(data);
+        }
+        else
+        {
+            auto &front = std::get<I>(tuple_pack);
+            using FT = std::decay_t<decltype(front)>;
+
+            // if operator is not an extract or from operation (extract operation is
+            // performed last and from has no operations) the perform processing and
+            // continue with processing for rest in list
+            if constexpr (FT::operation != extract_name() &&
+                          FT::operation != from_name() &&
+                          FT::operation != profile_name() &&
+                          FT::operation != cancellation_name() &&
+                          FT::operation != memory_budget_name())
+            {
+                auto result = processStage(tuple_pack, FT::operation, data,
+                                           [&]() { return processWithinBudget(tuple_pack, front, std::move(data)); });
+                return processOperationSequence<I + 1>(tuple_pack, std::move(result));
+            }
+            else
+            {
+                return processOperationSequence<I + 1>(tuple_pack, std::move(data));
+            }
+        }
+    }
+    #pragma clang diagnostic pop
+
+    // one published version of a versionedSource, immutable once published
+    template<typename CT>
+    struct sourceVersion
+    {
+        CT data_;
+        uint64_t number_;
+        mutable std::atomic<size_t> readers_{0};
+
+        sourceVersion(CT data, uint64_t number)
+            :data_(std::move(data)), number_(number)
+        { }
+    };
+
+    // a counted reference to one version of a versionedSource, the version is
+    // not reclaimed while a snapshot of it exists. Used as the data of a from,
+    // from{source.snapshot()}, the query reads the version in place.
+    template<typename CT>
+    class versionSnapshot
+    {
+    public:
+        using value_type = typename CT::value_type;
+        using const_iterator = typename CT::const_iterator;
+        using iterator = const_iterator;
+
+        // takes over a reference already counted for the version
+        explicit versionSnapshot(const sourceVersion<CT> *version)
+            :version_(version)
+        { }
+
+        versionSnapshot(const versionSnapshot &other)
+            :version_(other.version_)
+        {
+            version_->readers_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        versionSnapshot(versionSnapshot &&other) noexcept
+            :version_(std::exchange(other.version_, nullptr))
+        { }
+
+        versionSnapshot &operator=(versionSnapshot other) noexcept
+        {
+            std::swap(version_, other.version_);
+            return *this;
+        }
+
+        ~versionSnapshot()
+        {
+            if(version_)
+                version_->readers_.fetch_sub(1, std::memory_order_release);
+        }
+
+        const CT &container() const { return version_->data_; }
+        uint64_t version() const { return version_->number_; }
+
+        const_iterator begin() const { return version_->data_.begin(); }
+        const_iterator end() const { return version_->data_.end(); }
+        size_t size() const { return version_->data_.size(); }
+        bool empty() const { return version_->data_.empty(); }
+
+    private:
+        const sourceVersion<CT> *version_;
+    };
+
+    // compile time check for a snapshot of a versionedSource
+    template<typename T>
+    using source_snapshot_type = decltype(std::declval<const T&>().container());
+
+    // versionedSource
+    // a source readers query without locks while a writer publishes new
+    // versions of the data. A published version is never changed, a reader
+    // takes a snapshot, a counted reference to the current version, and
+    // queries it with from{source.snapshot()} so the source is neither locked
+    // nor copied by the from.
+    //
+    // Versions are reclaimed epoch based. A reader announces the current
+    // epoch in a reader slot only while it takes its reference, and a writer
+    // retires the version it replaces with the epoch it was replaced in. A
+    // retired version is freed once no reader slot announces an epoch at or
+    // before its retirement and no snapshot of it is left. Readers never free
+    // a version, retired versions are freed by the writer on each publish or
+    // by reclaim().
+    //
+    // Writers are serialized by a mutex. Snapshots must not outlive the
+    // source.
+    template<typename CT>
+    class versionedSource
+    {
+    public:
+        using value_type = typename CT::value_type;
+
+        versionedSource(CT data = CT{}, size_t reader_slots = 64)
+            :slots_(std::make_unique<readerSlot[]>(std::max<size_t>(reader_slots, 1))),
+             slot_count_(std::max<size_t>(reader_slots, 1)),
+             current_(new sourceVersion<CT>{std::move(data), 0})
+        { }
+
+        versionedSource(const versionedSource&) = delete;
+        versionedSource &operator=(const versionedSource&) = delete;
+
+        ~versionedSource()
+        {
+            delete current_.load();
+            for(auto &retired : retired_)
+                delete retired.first;
+        }
+
+        // a snapshot of the current version, lock free
+        versionSnapshot<CT> snapshot() const
+        {
+            auto &slot = claimSlot();
+
+            auto *version = current_.load();
+            version->readers_.fetch_add(1, std::memory_order_relaxed);
+
+            slot.epoch_.store(0);
+            return versionSnapshot<CT>{version};
+        }
+
+        // publish data as the new current version
+        void publish(CT data)
+        {
+            std::lock_guard<std::mutex> lock(writer_);
+            publishVersion(std::move(data));
+        }
+
+        // publish a copy of the current version changed by update, called with
+        // the copy
+        template<typename UT>
+        void update(UT update)
+        {
+            std::lock_guard<std::mutex> lock(writer_);
+
+            CT data = current_.load()->data_;
+            update(data);
+            publishVersion(std::move(data));
+        }
+
+        // number of the current version, the first version is 0
+        uint64_t version() const { return current_.load()->number_; }
+
+        // free the retired versions no reader can still use
+        void reclaim()
+        {
+            std::lock_guard<std::mutex> lock(writer_);
+            reclaimRetired();
+        }
+
+        // number of retired versions not yet freed
+        size_t retained() const
+        {
+            std::lock_guard<std::mutex> lock(writer_);
+            return retired_.size();
+        }
+
+    private:
+        // a reader slot on its own cache line, the epoch announced by a
+        // reader taking a reference, 0 when the slot is free
+        struct alignas(64) readerSlot
+        {
+            std::atomic<uint64_t> epoch_{0};
+        };
+
+        std::unique_ptr<readerSlot[]> slots_;
+        size_t slot_count_;
+
+        std::atomic<sourceVersion<CT>*> current_;
+        std::atomic<uint64_t> epoch_{1};
+
+        mutable std::mutex writer_;
+        std::vector<std::pair<sourceVersion<CT>*, uint64_t>> retired_;
+
+        // claim a free reader slot announcing the current epoch, starting from
+        // a slot picked by the thread so readers rarely contend for a slot
+        readerSlot &claimSlot() const
+        {
+            auto first = std::hash<std::thread::id>{}(std::this_thread::get_id()) % slot_count_;
+
+            for(;;)
+            {
+                for(size_t offset = 0; offset < slot_count_; ++offset)
+                {
+                    auto &slot = slots_[(first + offset) % slot_count_];
+
+                    uint64_t expected = 0;
+                    if(slot.epoch_.load(std::memory_order_relaxed) == 0 &&
+                       slot.epoch_.compare_exchange_strong(expected, epoch_.load()))
+                        return slot;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        void publishVersion(CT data)
+        {
+            auto *previous = current_.load();
+            current_.store(new sourceVersion<CT>{std::move(data), previous->number_ + 1});
+
+            retired_.emplace_back(previous, epoch_.fetch_add(1));
+            reclaimRetired();
+        }
+
+        // the slots are read before the reader counts, a reader announcing an
+        // early enough epoch may not have counted its reference yet, and a
+        // reader that has released its slot has already counted it
+        void reclaimRetired()
+        {
+            uint64_t oldest = std::numeric_limits<uint64_t>::max();
+            for(size_t index = 0; index < slot_count_; ++index)
+            {
+                auto epoch = slots_[index].epoch_.load();
+                if(epoch != 0)
+                    oldest = std::min(oldest, epoch);
+            }
+
+            auto last = std::remove_if(retired_.begin(), retired_.end(), [oldest](const auto &retired) {
+                                           if(oldest <= retired.second ||
+                                              retired.first->readers_.load(std::memory_order_acquire) != 0)
+                                               return false;
+
+                                           delete retired.first;
+                                           return true;
+                                       });
+            retired_.erase(last, retired_.end());
+        }
+    };
+
+    // run a stage that reads the source in place (an index lookup or a
+    // where on a snapshot) within the memory budget, if one is given. The
+    // source is not held by the processing, only the results are counted,
+    // each element is checked as the stage adds it with the given appender.
+    template<typename TT, typename ST>
+    auto sourceStageWithinBudget(const TT &tuple_pack, std::string_view operation_name, ST stage)
+    {
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+        auto append = makeStageAppend(tuple_pack, operation_name);
+
+        if constexpr(budget_op.operation == default_indicator_name())
+        {
+            return stage(append);
+        }
+        else
+        {
+            auto results = stage(append);
+            budget_op.finished(operation_name, 0, 0, estimatedAllocatedBytes(results), 0);
+            return results;
+        }
+    }
+
+    // the source data as a container the operations can process, a snapshot
+    // of a versionedSource, or an index source, is copied and the copy is
+    // checked against the memory budget before it is made
+    template<typename TT, typename DT>
+    auto sourceContainer([[maybe_unused]] const TT &tuple_pack, DT &&data)
+    {
+        if constexpr(std::experimental::is_detected<source_snapshot_type, std::decay_t<DT>>::value)
+        {
+            auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                    std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            if constexpr(budget_op.operation != default_indicator_name())
+            {
+                auto source_bytes = estimatedAllocatedBytes(data.container());
+                if(!budget_op.fits(source_bytes))
+                    budget_op.exceeded(from_name(), source_bytes);
+            }
+
+            return sourceStageWithinBudget(tuple_pack, from_name(), [&](auto &) { return data.container(); });
+        }
+        else
+            return std::move(data);
+    }
+
+    // process the linqcpp operations on the source data, a where given
+    // before any other operation with an index lookup, on the source of the
+    // index read in place and with the index current for it, is answered by
+    // the index rather than a scan of the data. A snapshot of a
+    // versionedSource, or an index source, is filtered in place by a first
+    // where, otherwise it is copied for the operations.
+    template<size_t I, typename TT, typename DT>
+    auto processSourceSequence(TT &tuple_pack, DT &&data)
+    {
+        if constexpr (I == std::tuple_size<TT>{})
+        {
+            return processOperationSequence<I>(tuple_pack, sourceContainer(tuple_pack, std::move(data)));
+        }
+        else
+        {
+            auto &front = std::get<I>(tuple_pack);
+            using FT = std::decay_t<decltype(front)>;
+
+            if constexpr (FT::operation == extract_name() ||
+                          FT::operation == from_name() ||
+                          FT::operation == profile_name() ||
+                          FT::operation == cancellation_name() ||
+                          FT::operation == memory_budget_name())
+            {
+                return processSourceSequence<I + 1>(tuple_pack, std::move(data));
+            }
+            else if constexpr (FT::operation == where_name())
+            {
+                if constexpr (std::experimental::is_detected<source_snapshot_type, DT>::value &&
+                              std::experimental::is_detected<index_lookup_type, decltype(front.where_operation_)>::value)
+                {
+                    // the source of the index read in place, only the matching
+                    // elements are copied
+                    if(front.where_operation_.current(data.container()))
+                    {
+                        auto result = processStage(tuple_pack, FT::operation, data.container(), [&]() {
+                                                       return sourceStageWithinBudget(tuple_pack, FT::operation, [&](auto &append) {
+                                                                  return front.where_operation_.lookup(append);
+                                                              });
+                                                   });
+                        return processOperationSequence<I + 1>(tuple_pack, std::move(result));
+                    }
+                }
+
+                if constexpr (std::experimental::is_detected<source_snapshot_type, DT>::value)
+                {
+                    // filter the snapshot in place, only the elements that pass
+                    // are copied
+                    auto result = processStage(tuple_pack, FT::operation, data.container(), [&]() {
+                                                   return sourceStageWithinBudget(tuple_pack, FT::operation, [&](auto &append) {
+                                                              std::decay_t<decltype(data.container())> results;
+                                                              for(const auto &value : data)
+                                                              {
+                                                                  if(front.where_operation_(value))
+                                                                      append(results, value);
+                                                              }
+                                                              return results;
+                                                          });
+                                               });
+                    return processOperationSequence<I + 1>(tuple_pack, std::move(result));
+                }
+                else
+                {
+                    return processOperationSequence<I>(tuple_pack, std::move(data));
+                }
+            }
+            else
+            {
+                return processOperationSequence<I>(tuple_pack, sourceContainer(tuple_pack, std::move(data)));
+            }
+        }
+    }
+
+    // start of a processing, the source data is held by the processing
+    template<typename TT, typename DT>
+    void startBudget([[maybe_unused]] const TT &tuple_pack, [[maybe_unused]] const DT &data)
+    {
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+        if constexpr(budget_op.operation != default_indicator_name())
+        {
+            // a snapshot is read in place, it is not held by the processing
+            if constexpr(std::experimental::is_detected<source_snapshot_type, DT>::value)
+                budget_op.start(0);
+            else
+                budget_op.start(estimatedAllocatedBytes(data));
+        }
+    }
+
+    // compile time count of the given named operation in the operation types
+    template<typename ...TArgs, typename NT>
+    constexpr auto numberOfNamedOperationTypes(NT op_name)
+    {
+        return (0 + ... + (TArgs::operation == op_name() ? 1 : 0));
+    }
+
+    // compile time validation of the requested linqcpp operations
+    template<typename ...TArgs>
+    constexpr void validateOperations()
+    {
+        static_assert(numberOfNamedOperationTypes<TArgs...>(to_collection_name) < 2, 
+                "Only one container coversion can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(order_by_name) < 2,
+                "Only one orderBy operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(extract_name) < 2,
+                "Only one extract operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(pre_sort_unique_name) < 2,
+                "Only one pre sorted container unique operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(stable_unique_name) < 2,
+                "Only one stable unique operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(profile_name) < 2,
+                "Only one profile operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(optimize_name) < 2,
+                "Only one optimize operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(skip_name) < 2,
+                "Only one skip operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(take_name) < 2,
+                "Only one take operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(cancellation_name) < 2,
+                "Only one cancellation operation can be specified");
+
+        static_assert(numberOfNamedOperationTypes<TArgs...>(memory_budget_name) < 2,
+                "Only one memory budget operation can be specified");
+    }
+
+    // the rewrites an optimize operation applied to the operations
+    struct optimizerReport
+    {
+        std::vector<std::string> rewrites_;
+    };
+
+    // optimize operation
+    // processes the operations in an equivalent, cheaper, order. Each where
+    // is moved before the orderBy, and the stableUnique and preSortUnique with
+    // no predicate, it follows, so less data is sorted or checked for
+    // duplicates, and adjacent wheres are merged into a where testing all the
+    // predicates in one pass. Operations are never moved across a top,
+    // bottom, window or any other operation whose results depend on the
+    // elements it is given. A uniqueness with no predicate is assumed to be
+    // by an equality that where predicates respect, i.e. equal elements pass
+    // or fail a where together. The report, if given, is filled with the
+    // rewrites applied.
+    //
+    // Only where pushdown and merging are done. The extract is not moved
+    // earlier to narrow the elements the other stages handle, their
+    // predicates take the source elements and not the extracted ones, so
+    // the extract always runs last.
+    struct optimize
+    {
+        static constexpr auto operation = optimize_name();
+
+        optimizerReport *report_ = nullptr;
+
+        optimize() = default;
+        optimize(optimizerReport &report)
+            :report_(&report)
+        { }
+    };
+
+    // where predicate testing each of a number of predicates, in order
+    template<typename ...PT>
+    struct allOf
+    {
+        std::tuple<PT...> predicates_;
+
+        allOf(PT ...predicates)
+            :predicates_(std::move(predicates)...)
+        { }
+
+        template<typename VT>
+        bool operator()(const VT &value) const
+        {
+            return std::apply([&value](const auto& ...predicates) {
+                                  return (... && predicates(value));
+                              }, predicates_);
+        }
+    };
+
+    // how the optimizer treats an operation, a where (that can be merged), a
+    // where answered by an index (moved but not merged), an operation a
+    // where can be moved before, or a barrier no where is moved across
+    enum class plan_kind { where, indexed_where, commutes, barrier };
+
+    template<typename OT>
+    constexpr plan_kind planKind()
+    {
+        if constexpr(OT::operation == where_name())
+        {
+            if constexpr(std::experimental::is_detected<index_lookup_type,
+                                                        decltype(std::declval<OT&>().where_operation_)>::value)
+                return plan_kind::indexed_where;
+            else
+                return plan_kind::where;
+        }
+        else if constexpr(OT::operation == stable_unique_name() || OT::operation == pre_sort_unique_name())
+        {
+            if constexpr(std::experimental::is_detected<pred_type, decltype(std::declval<OT&>().unique_predicate_)>::value)
+                return plan_kind::commutes;
+            else
+                return plan_kind::barrier;
+        }
+        else if constexpr(OT::operation == order_by_name() ||
+                          OT::operation == extract_name() || OT::operation == from_name() ||
+                          OT::operation == profile_name() || OT::operation == optimize_name() ||
+                          OT::operation == to_collection_name() || OT::operation == cancellation_name() ||
+                          OT::operation == memory_budget_name())
+            return plan_kind::commutes;
+        else
+            return plan_kind::barrier;
+    }
+
+    // an orderBy using operator<, its results have equal elements adjacent
+    template<typename OT>
+    constexpr bool ordersByOperatorLess()
+    {
+        if constexpr(OT::operation == order_by_name())
+            return defaultOrdering<OT>();
+        else
+            return false;
+    }
+
+    // compile time processing plan of an operations tuple
+    template<typename TT>
+    struct queryPlan;
+
+    template<typename ...TArgs>
+    struct queryPlan<std::tuple<TArgs...>>
+    {
+        static constexpr size_t count_ = sizeof...(TArgs);
+
+        static constexpr bool isWhere(plan_kind kind)
+        {
+            return kind == plan_kind::where || kind == plan_kind::indexed_where;
+        }
+
+        // the plan kind of each operation. A preSortUnique removes adjacent
+        // duplicates only, a where moved before it on unsorted data changes
+        // which duplicates are adjacent, so it commutes only after an orderBy
+        // using operator< with nothing but wheres and uniqueness between.
+        static constexpr std::array<plan_kind, count_> kinds()
+        {
+            std::array<plan_kind, count_> results{planKind<TArgs>()...};
+            constexpr std::string_view names[count_] = {TArgs::operation...};
+            constexpr bool sorted_by_less[count_] = {ordersByOperatorLess<TArgs>()...};
+
+            for(size_t i = 0; i < count_; ++i)
+            {
+                if(names[i] != pre_sort_unique_name() || results[i] != plan_kind::commutes)
+                    continue;
+
+                bool sorted = false;
+                for(size_t j = i; j > 0; --j)
+                {
+                    auto name = names[j - 1];
+                    if(name == order_by_name())
+                    {
+                        sorted = sorted_by_less[j - 1];
+                        break;
+                    }
+
+                    if(!isWhere(results[j - 1]) && name != stable_unique_name() && name != pre_sort_unique_name() &&
+                       name != from_name() && name != extract_name() && name != profile_name() &&
+                       name != optimize_name() && name != to_collection_name() && name != cancellation_name() &&
+                       name != memory_budget_name())
+                        break;
+                }
+
+                if(!sorted)
+                    results[i] = plan_kind::barrier;
+            }
+
+            return results;
+        }
+
+        // original operation index for each position, each where moved back
+        // past the operations it commutes with
+        static constexpr std::array<size_t, count_> order()
+        {
+            constexpr auto kinds = queryPlan::kinds();
+
+            std::array<size_t, count_> order{};
+            for(size_t i = 0; i < count_; ++i)
+                order[i] = i;
+
+            for(size_t i = 0; i < count_; ++i)
+            {
+                if(!isWhere(kinds[order[i]]))
+                    continue;
+
+                for(size_t j = i; j > 0 && kinds[order[j - 1]] == plan_kind::commutes; --j)
+                {
+                    auto moved = order[j];
+                    order[j] = order[j - 1];
+                    order[j - 1] = moved;
+                }
+            }
+
+            return order;
+        }
+
+        // the planned operations, the positions of the order grouped with
+        // adjacent mergeable wheres in one group and the optimize operation
+        // left out
+        struct groups
+        {
+            std::array<size_t, count_> first_{};
+            std::array<size_t, count_> size_{};
+            size_t group_count_ = 0;
+        };
+
+        static constexpr groups planGroups()
+        {
+            constexpr auto kinds = queryPlan::kinds();
+            constexpr std::string_view names[count_] = {TArgs::operation...};
+            constexpr auto positions = order();
+
+            groups planned{};
+            for(size_t position = 0; position < count_; ++position)
+            {
+                auto index = positions[position];
+                if(names[index] == optimize_name())
+                    continue;
+
+                auto previous = planned.group_count_ == 0 ? count_ :
+                                positions[planned.first_[planned.group_count_ - 1] + planned.size_[planned.group_count_ - 1] - 1];
+
+                if(kinds[index] == plan_kind::where && previous != count_ &&
+                   kinds[previous] == plan_kind::where &&
+                   planned.first_[planned.group_count_ - 1] + planned.size_[planned.group_count_ - 1] == position)
+                {
+                    ++planned.size_[planned.group_count_ - 1];
+                }
+                else
+                {
+                    planned.first_[planned.group_count_] = position;
+                    planned.size_[planned.group_count_] = 1;
+                    ++planned.group_count_;
+                }
+            }
+
+            return planned;
+        }
+
+        // describe the rewrites of the plan
+        static std::vector<std::string> rewrites()
+        {
+            constexpr auto kinds = queryPlan::kinds();
+            constexpr std::string_view names[count_] = {TArgs::operation...};
+            constexpr auto positions = order();
+            constexpr auto planned = planGroups();
+
+            auto describe = [&names](size_t index) {
+                return std::string{names[index]} + " (operation " + std::to_string(index) + ")";
+            };
+
+            std::array<size_t, count_> position_of{};
+            for(size_t position = 0; position < count_; ++position)
+                position_of[positions[position]] = position;
+
+            std::vector<std::string> results;
+            for(size_t index = 0; index < count_; ++index)
+            {
+                if(!isWhere(kinds[index]))
+                    continue;
+
+                for(size_t passed = 0; passed < index; ++passed)
+                {
+                    auto name = names[passed];
+                    bool stage = name == order_by_name() || name == stable_unique_name() ||
+                                 name == pre_sort_unique_name();
+
+                    if(stage && position_of[passed] > position_of[index])
+                        results.push_back("moved " + describe(index) + " before " + describe(passed));
+                }
+            }
+
+            for(size_t group = 0; group < planned.group_count_; ++group)
+            {
+                for(size_t merged = 1; merged < planned.size_[group]; ++merged)
+                {
+                    results.push_back("merged " + describe(positions[planned.first_[group] + merged]) +
+                                      " into " + describe(positions[planned.first_[group]]));
+                }
+            }
+
+            return results;
+        }
+    };
+
+    // the operations of a planned group, a single operation or the wheres of
+    // the group merged into one where
+    template<size_t G, typename TT, size_t... Is>
+    auto plannedStage(TT &operations, std::index_sequence<Is...>)
+    {
+        constexpr auto order = queryPlan<TT>::order();
+        constexpr auto planned = queryPlan<TT>::planGroups();
+        constexpr auto first = planned.first_[G];
+
+        if constexpr(sizeof...(Is) == 1)
+            return std::move(std::get<order[first]>(operations));
+        else
+            return where{allOf{std::move(std::get<order[first + Is]>(operations).where_operation_)...}};
+    }
+
+    // the operations in their planned order, with the optimize operation
+    // removed, the operations are moved into the plan
+    template<typename TT, size_t... Gs>
+    auto plannedOperations(TT &operations, std::index_sequence<Gs...>)
+    {
+        constexpr auto planned = queryPlan<TT>::planGroups();
+
+        return std::make_tuple(plannedStage<Gs>(operations, std::make_index_sequence<planned.size_[Gs]>{})...);
+    }
+
+    // plan the operations of an optimize operation, filling its report
+    template<typename ...TArgs>
+    auto optimizeOperations(TArgs ...args)
+    {
+        using operations_type = std::tuple<TArgs...>;
+        std::tuple<TArgs...> operations(std::move(args)...);
+
+        auto optimize_op = findOperationFromTuple(optimize_name, operations,
+                                                  std::make_index_sequence<sizeof...(TArgs)>{});
+        if(optimize_op.report_)
+            optimize_op.report_->rewrites_ = queryPlan<operations_type>::rewrites();
+
+        constexpr auto planned = queryPlan<operations_type>::planGroups();
+        return plannedOperations(operations, std::make_index_sequence<planned.group_count_>{});
+    }
+
+    // the source data of the from operation in the operations tuple
+    template<typename TT>
+    auto &sourceData(TT &tuple_pack)
+    {
+        return std::get<tupleOperations<TT>::index(from_name)>(tuple_pack).from_data;
+    }
+
+    // compile time check the memory budget of the operations, if there is
+    // one, spills
+    template<typename TT>
+    constexpr bool budgetSpills()
+    {
+        using budget_type = decltype(findOperationFromTuple(memory_budget_name, std::declval<const TT&>(),
+                                                            std::make_index_sequence<std::tuple_size<TT>{}>{}));
+
+        if constexpr(budget_type::operation == default_indicator_name())
+            return false;
+        else
+            return budget_type::spill_;
+    }
+
+    // compile time check an orderBy can be spilled, it is the only operation
+    // that changes the elements, the source is read in place, its elements are
+    // trivially copyable and an extract makes sequence results from them. The
+    // ordered elements then stream from the runs of an externalSort through
+    // the extract, neither a copy of the source nor the ordered data is held.
+    template<typename TT, typename DT>
+    constexpr bool orderByCanSpill()
+    {
+        constexpr auto names = tupleOperations<TT>::names_;
+        constexpr auto order_by_index = tupleOperations<TT>::index(order_by_name);
+
+        if constexpr(!std::experimental::is_detected<source_snapshot_type, DT>::value ||
+                     order_by_index == names.size() ||
+                     tupleOperations<TT>::index(extract_name) == names.size())
+        {
+            return false;
+        }
+        else
+        {
+            constexpr auto container_type = decltype(findOperationFromTuple(to_collection_name, std::declval<const TT&>(),
+                                                     std::make_index_sequence<std::tuple_size<TT>{}>{}))::container_type;
+
+            if(!std::is_trivially_copyable_v<typename DT::value_type> ||
+               !(container_type == as_vector() || container_type == as_deque() || container_type == as_list()))
+                return false;
+
+            for(size_t index = 0; index < names.size(); ++index)
+            {
+                if(index != order_by_index && !passesElementsThrough(names[index]))
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    // compile time check a stableUnique can be spilled, it has no predicate
+    // and its elements, the source elements as there is no window before it,
+    // are trivially copyable with an operator<
+    template<typename TT, typename DT>
+    constexpr bool stableUniqueCanSpill()
+    {
+        constexpr auto stable_unique_index = tupleOperations<TT>::index(stable_unique_name);
+
+        if constexpr(stable_unique_index < std::tuple_size<TT>{})
+        {
+            using value_type = typename DT::value_type;
+            using predicate_type = decltype(std::get<stable_unique_index>(std::declval<const TT&>()).unique_predicate_);
+
+            if(std::is_trivially_copyable_v<value_type> &&
+               std::experimental::is_detected<contains_less, value_type>::value &&
+               std::experimental::is_detected<pred_type, predicate_type>::value &&
+               tupleOperations<TT>::index(window_name) > stable_unique_index &&
+               tupleOperations<TT>::index(time_window_name) > stable_unique_index)
+                return true;
+        }
+
+        return false;
+    }
+
+    // an orderBy spilled out of the memory budget, the source read in place is
+    // sorted by an externalSort within the bytes still available and the
+    // merged runs are passed through the extract into the results. Each
+    // extracted element is checked against the budget as it is added and the
+    // cancellation, if there is one, after each chunk.
+    template<typename RT, typename TT, typename ST, typename ...TArgs>
+    void spilledOrderBy(RT &results, const TT &tuple_pack, const ST &source, TArgs& ...args)
+    {
+        using value_type = typename ST::value_type;
+
+        auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                std::make_index_sequence<std::tuple_size<TT>{}>{});
+        auto cancel_op = findOperation(cancellation_name, args...);
+        auto order_by_op = findOperation(order_by_name, args...);
+        auto extract_op = findOperation(extract_name, args...);
+        auto append = makeStageAppend(tuple_pack, order_by_name());
+
+        size_t emitted = 0;
+        auto emit = [&](const value_type &value) {
+            append.appendNew(results, extract_op.extract_operation_(value));
+
+            if constexpr(cancel_op.operation != default_indicator_name())
+            {
+                if(++emitted % cancelWhen::chunk_size_ == 0)
+                    cancel_op.check();
+            }
+        };
+
+        // passes each merged element to emit
+        struct emitIterator
+        {
+            using iterator_category [[maybe_unused]] = std::output_iterator_tag;
+            using value_type [[maybe_unused]] = void;
+            using difference_type [[maybe_unused]] = std::ptrdiff_t;
+            using pointer [[maybe_unused]] = void;
+            using reference [[maybe_unused]] = void;
+
+            decltype(emit) *emit_;
+
+            emitIterator &operator*() { return *this; }
+            emitIterator &operator++() { return *this; }
+            emitIterator operator++(int) { return *this; }
+            emitIterator &operator=(const typename ST::value_type &value)
+            {
+                (*emit_)(value);
+                return *this;
+            }
+        };
+
+        auto compare = [&order_by_op](const value_type &lhs, const value_type &rhs) {
+            if constexpr(defaultOrdering<decltype(order_by_op)>())
+                return lhs < rhs;
+            else
+                return order_by_op.order_by_operation_(lhs, rhs);
+        };
+
+        processStage(tuple_pack, order_by_name(), source, [&]() -> const RT& {
+                         budget_op.spilled(order_by_name());
+
+                         externalSort<> sorter{std::max<size_t>(budget_op.available(), sizeof(value_type))};
+                         sorter.sort(source.begin(), source.end(), emitIterator{&emit}, compare);
+
+                         budget_op.finished(order_by_name(), 0, 0, estimatedAllocatedBytes(results), 0);
+                         return results;
+                     });
+    }
+
+    // the source of the operations is read in place and too large to be
+    // copied within a spilling memory budget for a spillable orderBy
+    template<typename TT, typename DT>
+    bool spillOrderBy([[maybe_unused]] const TT &tuple_pack, [[maybe_unused]] const DT &data)
+    {
+        if constexpr(budgetSpills<TT>() && orderByCanSpill<TT, DT>())
+        {
+            auto budget_op = findOperationFromTuple(memory_budget_name, tuple_pack,
+                                                    std::make_index_sequence<std::tuple_size<TT>{}>{});
+
+            return !budget_op.fits(estimatedAllocatedBytes(data.container()));
+        }
+        else
+            return false;
+    }
+
+    // process the operations held in tuple_pack, args are the operations of
+    // the tuple. The source data is moved out of its from operation, each
+    // stage then moves the data it owns on to the next.
+    template<typename TT, typename ...TArgs>
+    auto processOperations(TT &tuple_pack, TArgs& ...args)
+    {
+        using source_type = std::decay_t<decltype(sourceData(tuple_pack))>;
+        static_assert(!budgetSpills<TT>() || stableUniqueCanSpill<TT, source_type>() ||
+                      orderByCanSpill<TT, source_type>(),
+                "linqcpp - a memory budget spill policy needs a stage that can spill, a stableUnique with no predicate "
+                "or an orderBy of a source read in place then extracted, of trivially copyable elements");
+
+        auto &source_data = sourceData(tuple_pack);
+        startProfile(tuple_pack);
+        startBudget(tuple_pack, source_data);
+
+        auto extract_op = findOperation(extract_name, args...);
+
+        if constexpr(orderByCanSpill<TT, source_type>())
+        {
+            if(spillOrderBy(tuple_pack, source_data))
+            {
+                using extract_type = std::decay_t<decltype(extract_op.extract_operation_(*source_data.begin()))>;
+                auto results = findOperation(to_collection_name, args...).template results_collection<extract_type>(args...);
+                spilledOrderBy(results, tuple_pack, source_data.container(), args...);
+                return results;
+            }
+        }
+
+        // process the linqcpp operations
+        auto process_results = processSourceSequence<0>(tuple_pack, std::move(source_data));
+
+        if constexpr(decltype(extract_op)::operation!=default_indicator_name())
+        {
+            using results_type = decltype(extract_op.process(std::move(process_results), args...));
+
+            // extract operation performed last to ensure data contains all
             // fields to extract.
-            auto extract_results = extract_op.process(std::move(process_results), args...);
+            auto extract_results = processStage(tuple_pack, extract_name(), process_results, [&]() {
+                                       return extractWithinBudget<results_type>(tuple_pack, process_results, [&]() {
+                                                  return extract_op.process(std::move(process_results), args...);
+                                              });
+                                   });
+
+            return extract_results;
+        }
+        else
+        {
+            return process_results;
+        }
+    }
+
+    // process 
+    template<typename ...TArgs>
+    auto processLinq(TArgs ...args)
+    {
+        validateOperations<TArgs...>();
+
+        if constexpr(numberOfNamedOperationTypes<TArgs...>(optimize_name) > 0)
+        {
+            // process the operations of the plan
+            return std::apply([](auto ...operations) { return processLinq(std::move(operations)...); },
+                              optimizeOperations(std::move(args)...));
+        }
+        else
+        {
+            // move the linqcpp operations into a tuple list so it can be used
+            // as a second operations list for operation searches, the
+            // operations are processed from the tuple so none are copied
+            auto tuple_pack = std::tuple<TArgs...>(std::move(args)...);
+
+            return std::apply([&tuple_pack](auto& ...operations) { return processOperations(tuple_pack, operations...); },
+                              tuple_pack);
+        }
+    }
+
+    // process the operations held in tuple_pack into the results container
+    template<typename RT, typename TT, typename ...TArgs>
+    void processOperationsInto(RT &results, TT &tuple_pack, TArgs& ...args)
+    {
+        using source_type = std::decay_t<decltype(sourceData(tuple_pack))>;
+        constexpr bool spill_order_by = orderByCanSpill<TT, source_type>() &&
+                                        std::experimental::is_detected<contains_push_back, RT, typename RT::value_type>::value;
+        static_assert(!budgetSpills<TT>() || stableUniqueCanSpill<TT, source_type>() || spill_order_by,
+                "linqcpp - a memory budget spill policy needs a stage that can spill, a stableUnique with no predicate "
+                "or an orderBy of a source read in place then extracted into a sequence, of trivially copyable elements");
+
+        auto &source_data = sourceData(tuple_pack);
+        startProfile(tuple_pack);
+        startBudget(tuple_pack, source_data);
+
+        if constexpr(spill_order_by)
+        {
+            if(spillOrderBy(tuple_pack, source_data))
+            {
+                results.clear();
+                spilledOrderBy(results, tuple_pack, source_data.container(), args...);
+                return;
+            }
+        }
+
+        auto process_results = processSourceSequence<0>(tuple_pack, std::move(source_data));
+
+        results.clear();
+
+        auto extract_op = findOperation(extract_name, args...);
+        if constexpr(decltype(extract_op)::operation!=default_indicator_name())
+        {
+            processStage(tuple_pack, extract_name(), process_results, [&]() -> const RT& {
+                             return extractWithinBudget<RT>(tuple_pack, process_results, [&]() -> const RT& {
+                                        extract_op.processInto(results, std::move(process_results), args...);
+                                        return results;
+                                    });
+                         });
+        }
+        else
+        {
+            // no extract, the processed data is owned here so move it into
+            // the results
+            auto identity = [](auto &&value) -> decltype(auto) { return std::move(value); };
+            fillCollection(results, process_results.begin(), process_results.end(), identity);
+        }
+    }
+
+    // process the linqcpp operations into a caller provided results container.
+    // results is cleared and then filled, any capacity it already has (vector
+    // and deque storage, unordered bucket arrays) is reused so repeated calls
+    // with the same results container do not reallocate it. The results
+    // container type is given by the caller so no as<Collection> operation can
+    // be specified.
+    template<typename RT, typename ...TArgs>
+    void processLinqInto(RT &results, TArgs ...args)
+    {
+        validateOperations<TArgs...>();
+
+        if constexpr(numberOfNamedOperationTypes<TArgs...>(optimize_name) > 0)
+        {
+            std::apply([&results](auto ...operations) { processLinqInto(results, std::move(operations)...); },
+                       optimizeOperations(std::move(args)...));
+        }
+        else
+        {
+            static_assert(numberOfNamedOperationTypes<TArgs...>(to_collection_name) == 0,
+                    "processLinqInto results container is given by the caller, no container conversion can be specified");
+
+            auto tuple_pack = std::tuple<TArgs...>(std::move(args)...);
+
+            std::apply([&](auto& ...operations) { processOperationsInto(results, tuple_pack, operations...); },
+                       tuple_pack);
+        }
+    }
+
+    // processLinqAsync
+    // runs processLinq on its own thread, the results, or the exception of
+    // the processing, are given by the returned future. With a cancelWhen
+    // operation the processing stops soon after its token is cancelled or its
+    // deadline passes and the future throws queryCancelled or
+    // queryDeadlineExceeded.
+    template<typename ...TArgs>
+    auto processLinqAsync(TArgs ...args)
+    {
+        return std::async(std::launch::async, [](TArgs ...operations) {
+                              return processLinq(std::move(operations)...);
+                          }, std::move(args)...);
+    }
+
+    // running sum of the projected value of each element, used as an
+    // aggregate of a materializedView
+    template<typename PT>
+    struct sumOf
+    {
+        static constexpr auto operation = aggregate_name();
+
+        PT projection_;
+        sumOf(PT projection)
+            :projection_(std::move(projection))
+        { }
+
+        // incremental state, a sum can be updated in constant time for any
+        // inserted or erased element
+        template<typename VT>
+        struct sumState
+        {
+            PT projection_;
+            std::decay_t<decltype(std::declval<PT&>()(std::declval<const VT&>()))> sum_{};
+
+            void insert(const VT &value) { sum_ += projection_(value); }
+            void erase(const VT &value) { sum_ -= projection_(value); }
+            auto value() const { return sum_; }
+        };
+
+        // state for element inserts and erases in any order
+        template<typename VT>
+        auto viewState() const { return sumState<VT>{projection_}; }
+
+        // state for windows where elements are erased oldest first
+        template<typename VT>
+        auto windowState() const { return sumState<VT>{projection_}; }
+
+        // state for a single pass where elements are only inserted
+        template<typename VT>
+        auto scanState() const { return sumState<VT>{projection_}; }
+    };
+
+    // running minimum or maximum of the projected value of each element, CT
+    // is the comparison that puts the required extreme first
+    template<typename PT, typename CT>
+    struct extremeOf
+    {
+        static constexpr auto operation = aggregate_name();
+
+        PT projection_;
+        extremeOf(PT projection)
+            :projection_(std::move(projection))
+        { }
+
+        // incremental state for inserts and erases in any order, the
+        // projected values are kept ordered so the extreme is always the first
+        template<typename VT>
+        struct orderedState
+        {
+            using key_type = std::decay_t<decltype(std::declval<PT&>()(std::declval<const VT&>()))>;
+
+            PT projection_;
+            std::multiset<key_type, CT> keys_;
+
+            void insert(const VT &value) { keys_.insert(projection_(value)); }
+            void erase(const VT &value) { keys_.erase(keys_.find(projection_(value))); }
+
+            // no value when there are no elements
+            std::optional<key_type> value() const
+            {
+                if(keys_.empty())
+                    return std::nullopt;
+
+                return *keys_.begin();
+            }
+        };
+
+        // incremental state for windows where elements are erased oldest
+        // first, a monotonic deque of the projected values that could still
+        // become the extreme, each value is added and removed once so updates
+        // are amortized constant time
+        template<typename VT>
+        struct monotonicState
+        {
+            using key_type = std::decay_t<decltype(std::declval<PT&>()(std::declval<const VT&>()))>;
+
+            PT projection_;
+            std::deque<key_type> keys_;
+            CT compare_;
+
+            void insert(const VT &value)
+            {
+                auto key = projection_(value);
+
+                // values the new value beats can never be the extreme again
+                while(!keys_.empty() && compare_(key, keys_.back()))
+                    keys_.pop_back();
+
+                keys_.push_back(std::move(key));
+            }
+
+            // value must be the oldest element in the window
+            void erase(const VT &value)
+            {
+                auto key = projection_(value);
+                if(!compare_(keys_.front(), key) && !compare_(key, keys_.front()))
+                    keys_.pop_front();
+            }
+
+            // a window is never empty
+            key_type value() const { return keys_.front(); }
+        };
+
+        // state for a single pass where elements are only inserted, the
+        // extreme so far
+        template<typename VT>
+        struct scanExtremeState
+        {
+            using key_type = std::decay_t<decltype(std::declval<PT&>()(std::declval<const VT&>()))>;
+
+            PT projection_;
+            std::optional<key_type> key_;
+            CT compare_;
+
+            void insert(const VT &value)
+            {
+                auto key = projection_(value);
+                if(!key_ || compare_(key, *key_))
+                    key_ = std::move(key);
+            }
+
+            // no value when there are no elements
+            std::optional<key_type> value() const { return key_; }
+        };
+
+        template<typename VT>
+        auto viewState() const { return orderedState<VT>{projection_, {}}; }
+
+        template<typename VT>
+        auto windowState() const { return monotonicState<VT>{projection_, {}, {}}; }
+
+        template<typename VT>
+        auto scanState() const { return scanExtremeState<VT>{projection_, std::nullopt, {}}; }
+    };
+
+    // running minimum of the projected value of each element
+    template<typename PT>
+    struct minOf : extremeOf<PT, std::less<>>
+    {
+        minOf(PT projection)
+            :extremeOf<PT, std::less<>>(std::move(projection))
+        { }
+    };
+
+    // running maximum of the projected value of each element
+    template<typename PT>
+    struct maxOf : extremeOf<PT, std::greater<>>
+    {
+        maxOf(PT projection)
+            :extremeOf<PT, std::greater<>>(std::move(projection))
+        { }
+    };
+
+    // the aggregated result of one window, first is the position of the
+    // windows first element in the data and count the number of elements in
+    // the window. aggregates holds the windows aggregate values in the order
+    // the aggregate operations were given.
+    template<typename ...VT>
+    struct windowResult
+    {
+        size_t first_;
+        size_t count_;
+        std::tuple<VT...> aggregates_;
+
+        template<size_t I>
+        const auto &aggregate() const { return std::get<I>(aggregates_); }
+    };
+
+    // create the incremental window state for each aggregate operation
+    template<typename VT, typename AT>
+    auto windowAggregateStates(const AT &aggregate_ops)
+    {
+        return std::apply([](const auto& ...ops) {
+                              return std::make_tuple(ops.template windowState<VT>()...);
+                          }, aggregate_ops);
+    }
+
+    // snapshot of the current window aggregate states
+    template<typename ST>
+    auto windowSnapshot(size_t first, size_t count, const ST &states)
+    {
+        return std::apply([first, count](const auto& ...window_states) {
+                              return windowResult<decltype(window_states.value())...>
+                                        {first, count, std::make_tuple(window_states.value()...)};
+                          }, states);
+    }
+
+    // window operation
+    // replaces the data with one windowResult for each window of size
+    // elements, a new window starting every slide elements. slide equal to
+    // size gives tumbling windows, smaller than size sliding windows. Only
+    // complete windows are produced. The aggregates are updated as elements
+    // enter and leave the window so each element costs amortized constant
+    // time however large the window.
+    template<typename ...AT>
+    struct window
+    {
+        static constexpr auto operation = window_name();
+
+        size_t size_;
+        size_t slide_;
+        std::tuple<AT...> aggregates_;
+
+        window(size_t size, size_t slide, AT ...aggregates)
+            :size_(size),
+             slide_(slide),
+             aggregates_(std::move(aggregates)...)
+        {
+            if(size_ == 0 || slide_ == 0)
+                throw std::invalid_argument("linqcpp - window size and slide must be greater than zero");
+        }
+
+        // process window operation
+        // tuple_data_pack - not used in this operation
+        // data - the data to window
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            auto states = windowAggregateStates<typename DT::value_type>(aggregates_);
+            std::vector<decltype(windowSnapshot(0, 0, states))> results;
+
+            size_t data_size = data.size();
+            if(data_size < size_)
+                return results;
+
+            results.reserve((data_size - size_) / slide_ + 1);
+
+            // the window is the elements between lower and upper
+            auto lower = data.begin();
+            auto upper = data.begin();
+            size_t lower_position = 0;
+            size_t upper_position = 0;
+
+            for(size_t first = 0; first + size_ <= data_size; first += slide_)
+            {
+                // remove the elements before the window, when slide is bigger
+                // than size some of those were never added
+                for(; lower_position < first; ++lower_position, ++lower)
+                {
+                    if(lower_position < upper_position)
+                        std::apply([&lower](auto& ...window_states) { (window_states.erase(*lower), ...); }, states);
+                }
+
+                if(upper_position < lower_position)
+                {
+                    upper = lower;
+                    upper_position = lower_position;
+                }
+
+                for(; upper_position < first + size_; ++upper_position, ++upper)
+                    std::apply([&upper](auto& ...window_states) { (window_states.insert(*upper), ...); }, states);
+
+                results.push_back(windowSnapshot(first, size_, states));
+            }
+
+            return results;
+        }
+    };
+
+    // timeWindow operation
+    // replaces the data with one windowResult for each element, the window
+    // holding the elements within duration of that element, ie. the elements
+    // with a timestamp in (timestamp - duration, timestamp]. The data must be
+    // in timestamp order, timestamp returns the timestamp of an element and
+    // can be any type whose difference compares with the duration (arithmetic
+    // or std::chrono::time_point). Aggregates are updated as the window
+    // moves so each element costs amortized constant time.
+    template<typename TS, typename DR, typename ...AT>
+    struct timeWindow
+    {
+        static constexpr auto operation = time_window_name();
+
+        TS timestamp_;
+        DR duration_;
+        std::tuple<AT...> aggregates_;
+
+        timeWindow(TS timestamp, DR duration, AT ...aggregates)
+            :timestamp_(std::move(timestamp)),
+             duration_(std::move(duration)),
+             aggregates_(std::move(aggregates)...)
+        { }
+
+        // process time window operation
+        // tuple_data_pack - not used in this operation
+        // data - timestamp ordered data to window
+        template<typename TT, typename DT>
+        auto process([[maybe_unused]] const TT &tuple_data_pack, DT &&data)
+        {
+            auto states = windowAggregateStates<typename DT::value_type>(aggregates_);
+            std::vector<decltype(windowSnapshot(0, 0, states))> results;
+            results.reserve(data.size());
+
+            auto lower = data.begin();
+            size_t lower_position = 0;
+            size_t position = 0;
+
+            for(auto upper = data.begin(); upper != data.end(); ++upper, ++position)
+            {
+                std::apply([&upper](auto& ...window_states) { (window_states.insert(*upper), ...); }, states);
+
+                // remove the elements that are older than the window, the
+                // window always holds at least the current element. Compared
+                // by the difference of the timestamps, subtracting the
+                // duration from an unsigned timestamp would wrap around
+                auto upper_timestamp = timestamp_(*upper);
+                for(; lower != upper && !(upper_timestamp - timestamp_(*lower) < duration_); ++lower, ++lower_position)
+                    std::apply([&lower](auto& ...window_states) { (window_states.erase(*lower), ...); }, states);
+
+                results.push_back(windowSnapshot(lower_position, position - lower_position + 1, states));
+            }
+
+            return results;
+        }
+    };
+
+    // compile time collect all the given named operations into a tuple
+    template<typename NT, typename ...TArgs>
+    auto findAllOperations([[maybe_unused]] NT name, const TArgs& ...args)
+    {
+        return std::tuple_cat([name, &args]() {
+                                  if constexpr(TArgs::operation == name())
+                                      return std::tuple<TArgs>{args};
+                                  else
+                                      return std::tuple<>{};
+                              }()...);
+    }
+
+    // create the incremental view state for each aggregate operation
+    template<typename VT, typename ...TArgs>
+    auto viewAggregateStates(const TArgs& ...args)
+    {
+        return std::apply([](const auto& ...aggregate_ops) {
+                              return std::make_tuple(aggregate_ops.template viewState<VT>()...);
+                          }, findAllOperations(aggregate_name, args...));
+    }
+
+    // compile time check for an equality operator
+    template<typename T>
+    using contains_equal = decltype(std::declval<const T&>() == std::declval<const T&>());
+
+    // materializedView
+    // keeps the results of a where / orderBy / unique query over a source up to
+    // date as elements are inserted into and erased from the source, each
+    // change costs time proportional to the change rather than re-running the
+    // query over the whole source.
+    //
+    // Equal elements are held once with a count, the unique operations use the
+    // count as the membership test so an element stays in the results until its
+    // last copy is erased. With an orderBy the results are kept in a multiset
+    // ordered by the orderBy predicate, without one the results keep the order
+    // the elements were first inserted in and a hash index (std::hash of the
+    // element) is used to find them. A unique predicate need not agree with
+    // the ordering so it must be given with a unique hash that agrees with
+    // it, the hash index is then built with the unique hash. The later copies
+    // are kept and the next one replaces the first when it is erased. A
+    // preSortUnique removes adjacent duplicates so it needs an orderBy.
+    //
+    // aggregate operations (sumOf, minOf, maxOf) are updated with each change
+    // and read with aggregate<I>() in the order the aggregates were given.
+    template<typename ...TArgs>
+    class materializedView
+    {
+    public:
+        using value_type = typename decltype(findOperation(from_name, std::declval<const TArgs&>()...))::value_type;
+        using size_type = std::size_t;
+
+    private:
+        using order_by_type = decltype(findOperation(order_by_name, std::declval<const TArgs&>()...));
+        using stable_unique_type = decltype(findOperation(stable_unique_name, std::declval<const TArgs&>()...));
+        using pre_sort_unique_type = decltype(findOperation(pre_sort_unique_name, std::declval<const TArgs&>()...));
+
+        static constexpr bool ordered_ = order_by_type::operation != default_indicator_name();
+        static constexpr bool stable_unique_ = stable_unique_type::operation != default_indicator_name();
+        static constexpr bool unique_ = stable_unique_ || 
+                                        pre_sort_unique_type::operation != default_indicator_name();
+
+        using unique_type = std::conditional_t<stable_unique_, stable_unique_type, pre_sort_unique_type>;
+
+        template<typename T>
+        using unique_predicate_type = decltype(std::declval<T>().unique_predicate_);
+
+        static constexpr bool unique_predicate_given_ = 
+                std::experimental::is_detected<unique_predicate_type, unique_type>::value &&
+                !std::experimental::is_detected<pred_type, 
+                                                std::experimental::detected_t<unique_predicate_type, unique_type>>::value;
+
+        template<typename T>
+        using unique_hash_type = decltype(std::declval<T>().unique_hash_);
+
+        static constexpr bool unique_hash_given_ = 
+                std::experimental::is_detected<unique_hash_type, unique_type>::value &&
+                !std::experimental::is_detected<pred_type, 
+                                                std::experimental::detected_t<unique_hash_type, unique_type>>::value;
+
+        // the entries are found through the hash index unless the orderBy
+        // equivalence can be used
+        static constexpr bool hash_indexed_ = !ordered_ || unique_predicate_given_;
+
+        // the copies after the first of an entry, held only with a unique
+        // predicate as they can differ from the first, otherwise an empty base
+        // that takes no space in the entry
+        struct heldCopies
+        {
+            mutable std::vector<value_type> copies_;
+        };
+
+        struct noCopies { };
+
+        // an element of the results, count is the number of copies inserted
+        struct entry : std::conditional_t<unique_predicate_given_, heldCopies, noCopies>
+        {
+            value_type value_;
+            mutable size_type count_;
+        };
 
-            return extract_results;
+        // orders the entries with the orderBy predicate, transparent so
+        // entries can be searched for with a plain value
+        struct entryCompare
+        {
+            using is_transparent = void;
+
+            order_by_type order_by_op_;
+
+            bool less(const value_type &lhs, const value_type &rhs) const
+            {
+                if constexpr(std::experimental::is_detected<pred_type, decltype(order_by_op_.order_by_operation_)>::value)
+                    return lhs < rhs;
+                else
+                    return order_by_op_.order_by_operation_(lhs, rhs);
+            }
+
+            bool operator()(const entry &lhs, const entry &rhs) const { return less(lhs.value_, rhs.value_); }
+            bool operator()(const value_type &lhs, const entry &rhs) const { return less(lhs, rhs.value_); }
+            bool operator()(const entry &lhs, const value_type &rhs) const { return less(lhs.value_, rhs); }
+        };
+
+        using store_type = std::conditional_t<ordered_, 
+                                              std::multiset<entry, entryCompare>,
+                                              std::list<entry>>;
+        using store_iterator = typename store_type::const_iterator;
+
+    public:
+        // iterates the results, without a unique operation each entry is
+        // repeated for each of its copies
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename materializedView::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = const value_type &;
+
+            const_iterator() = default;
+            const_iterator(store_iterator itr)
+                :itr_(itr)
+            { }
+
+            reference operator*() const { return itr_->value_; }
+            pointer operator->() const { return &itr_->value_; }
+
+            const_iterator &operator++()
+            {
+                if constexpr(!unique_)
+                {
+                    if(++copy_ < itr_->count_)
+                        return *this;
+
+                    copy_ = 0;
+                }
+
+                ++itr_;
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                auto current = *this;
+                ++(*this);
+                return current;
+            }
+
+            friend bool operator==(const const_iterator &lhs, const const_iterator &rhs)
+            {
+                return lhs.itr_ == rhs.itr_ && lhs.copy_ == rhs.copy_;
+            }
+
+            friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs)
+            {
+                return !(lhs == rhs);
+            }
+
+        private:
+            store_iterator itr_;
+            size_type copy_ = 0;
+        };
+
+        // args - the from operation holding the initial source data followed
+        //        by the where, orderBy, stableUnique / preSortUnique and
+        //        aggregate operations of the query
+        materializedView(TArgs ...args)
+            :where_operations_(findAllOperations(where_name, args...)),
+             unique_op_(findUniqueOperation(args...)),
+             store_(makeStore(args...)),
+             aggregates_(viewAggregateStates<value_type>(args...))
+        {
+            static_assert(numberOfNamedOperationTypes<TArgs...>(from_name) == 1,
+                    "materializedView requires one 'from' operation");
+
+            static_assert(numberOfNamedOperationTypes<TArgs...>(order_by_name) < 2,
+                    "Only one orderBy operation can be specified");
+
+            static_assert(numberOfNamedOperationTypes<TArgs...>(stable_unique_name) +
+                          numberOfNamedOperationTypes<TArgs...>(pre_sort_unique_name) < 2,
+                    "Only one unique operation can be specified");
+
+            static_assert(numberOfNamedOperationTypes<TArgs...>(from_name) +
+                          numberOfNamedOperationTypes<TArgs...>(where_name) +
+                          numberOfNamedOperationTypes<TArgs...>(order_by_name) +
+                          numberOfNamedOperationTypes<TArgs...>(stable_unique_name) +
+                          numberOfNamedOperationTypes<TArgs...>(pre_sort_unique_name) +
+                          numberOfNamedOperationTypes<TArgs...>(aggregate_name) == sizeof...(TArgs),
+                    "materializedView supports only from, where, orderBy, unique and aggregate operations");
+
+            static_assert(!unique_predicate_given_ || unique_hash_given_,
+                    "materializedView with a unique predicate needs a unique hash that agrees with it");
+
+            // a preSortUnique only removes adjacent duplicates, the view holds
+            // equal elements once so it would remove them all without an order
+            static_assert(pre_sort_unique_type::operation == default_indicator_name() || ordered_,
+                    "materializedView preSortUnique needs an orderBy, use stableUnique for unordered results");
+
+            const auto &from_op = operationAt<operationIndex<TArgs...>(from_name)>(args...);
+            insert(from_op.from_data.begin(), from_op.from_data.end());
+        }
+
+        // add an element to the source, returns true if it passes the where
+        // filters and so is part of the query
+        bool insert(const value_type &value)
+        {
+            if(!passesWhere(value))
+                return false;
+
+            auto itr = findEntry(value);
+            if(itr == store_.end())
+            {
+                itr = addEntry(value);
+                addToResults(itr->value_);
+            }
+            else
+            {
+                ++itr->count_;
+
+                if constexpr(unique_predicate_given_)
+                    itr->copies_.push_back(value);
+
+                if constexpr(!unique_)
+                    addToResults(itr->value_);
+            }
+
+            return true;
+        }
+
+        // remove an element from the source, returns true if the element was
+        // part of the query
+        bool erase(const value_type &value)
+        {
+            if(!passesWhere(value))
+                return false;
+
+            auto itr = findEntry(value);
+            if(itr == store_.end())
+                return false;
+
+            if constexpr(unique_predicate_given_)
+            {
+                if(!itr->copies_.empty())
+                {
+                    eraseCopy(itr, value);
+                    return true;
+                }
+            }
+
+            if(!unique_ || itr->count_ == 1)
+                removeFromResults(itr->value_);
+
+            if(--itr->count_ == 0)
+                removeEntry(itr);
+
+            return true;
+        }
+
+        // add a batch of elements to the source
+        template<typename IT>
+        void insert(IT first, IT last)
+        {
+            for(; first != last; ++first)
+                insert(*first);
+        }
+
+        // remove a batch of elements from the source
+        template<typename IT>
+        void erase(IT first, IT last)
+        {
+            for(; first != last; ++first)
+                erase(*first);
+        }
+
+        // number of elements in the results
+        size_type size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        const_iterator begin() const { return const_iterator{store_.begin()}; }
+        const_iterator end() const { return const_iterator{store_.end()}; }
+
+        // copy of the current results
+        std::vector<value_type> results() const
+        {
+            std::vector<value_type> current_results;
+            current_results.reserve(size_);
+            current_results.insert(current_results.end(), begin(), end());
+
+            return current_results;
+        }
+
+        // current value of the I'th aggregate operation
+        template<size_t I>
+        auto aggregate() const
+        {
+            return std::get<I>(aggregates_).value();
+        }
+
+    private:
+        using where_type = decltype(findAllOperations(where_name, std::declval<const TArgs&>()...));
+        using index_type = std::unordered_multimap<size_t, store_iterator>;
+        using aggregates_type = decltype(viewAggregateStates<value_type>(std::declval<const TArgs&>()...));
+
+        where_type where_operations_;
+        unique_type unique_op_;
+        store_type store_;
+        index_type index_;
+        aggregates_type aggregates_;
+        size_type size_ = 0;
+
+        // find the unique operation, stableUnique if given otherwise
+        // preSortUnique (or the not found indicator)
+        static auto findUniqueOperation(const TArgs& ...args)
+        {
+            if constexpr(stable_unique_)
+                return findOperation(stable_unique_name, args...);
+            else
+                return findOperation(pre_sort_unique_name, args...);
+        }
+
+        static store_type makeStore(const TArgs& ...args)
+        {
+            if constexpr(ordered_)
+                return store_type{entryCompare{findOperation(order_by_name, args...)}};
+            else
+                return store_type{};
+        }
+
+        bool passesWhere(const value_type &value)
+        {
+            return std::apply([&value](auto& ...where_ops) {
+                                  return (true && ... && where_ops.where_operation_(value));
+                              }, where_operations_);
+        }
+
+        // equality used to find an elements entry, the unique predicate if
+        // one is given otherwise the elements operator==
+        bool equalValues(const value_type &lhs, const value_type &rhs)
+        {
+            if constexpr(unique_predicate_given_)
+                return unique_op_.unique_predicate_(lhs, rhs);
+            else if constexpr(std::experimental::is_detected<contains_equal, value_type>::value)
+                return lhs == rhs;
+            else
+            {
+                // fall back to the order by equivalence
+                static_assert(ordered_, "materializedView elements need an operator== or a unique predicate");
+                return !store_.key_comp().less(lhs, rhs) && !store_.key_comp().less(rhs, lhs);
+            }
+        }
+
+        store_iterator findEntry(const value_type &value)
+        {
+            if constexpr(ordered_ && !unique_predicate_given_)
+            {
+                auto [first, last] = store_.equal_range(value);
+                auto itr = std::find_if(first, last, 
+                                        [&](const entry &e) { return equalValues(e.value_, value); });
+
+                return itr == last ? store_.end() : itr;
+            }
+            else
+            {
+                auto [first, last] = index_.equal_range(entryHash(value));
+                for(; first != last; ++first)
+                {
+                    if(equalValues(first->second->value_, value))
+                        return first->second;
+                }
+
+                return store_.end();
+            }
+        }
+
+        store_iterator addEntry(const value_type &value)
+        {
+            store_iterator itr;
+            if constexpr(ordered_)
+                itr = store_.insert(entry{{}, value, 1});
+            else
+                itr = store_.insert(store_.end(), entry{{}, value, 1});
+
+            if constexpr(hash_indexed_)
+                index_.emplace(entryHash(value), itr);
+
+            return itr;
+        }
+
+        // hash of the index, the unique hash if a unique predicate is given
+        // otherwise the elements std::hash
+        size_t entryHash(const value_type &value) const
+        {
+            if constexpr(unique_predicate_given_)
+                return static_cast<size_t>(unique_op_.unique_hash_(value));
+            else
+                return std::hash<value_type>{}(value);
+        }
+
+        // the index entry of the store entry
+        typename index_type::iterator findIndex(store_iterator itr)
+        {
+            auto [first, last] = index_.equal_range(entryHash(itr->value_));
+            for(; first != last; ++first)
+            {
+                if(first->second == itr)
+                    return first;
+            }
+
+            return index_.end();
+        }
+
+        // erase one copy of an entry that has more than one, with a unique
+        // predicate. A later copy equal to the value is erased if there is
+        // one, otherwise the first copy is erased if it is equal to the value
+        // and the next copy takes its place. Without an operator== the latest
+        // copy is erased.
+        void eraseCopy(store_iterator itr, const value_type &value)
+        {
+            auto &copies = itr->copies_;
+            --itr->count_;
+
+            auto copy = std::prev(copies.end());
+            if constexpr(std::experimental::is_detected<contains_equal, value_type>::value)
+            {
+                if(itr->value_ == value)
+                {
+                    removeFromResults(itr->value_);
+                    auto next = std::move(copies.front());
+                    copies.erase(copies.begin());
+                    addToResults(replaceValue(itr, std::move(next)));
+                    return;
+                }
+
+                auto equal = std::find(copies.begin(), copies.end(), value);
+                if(equal != copies.end())
+                    copy = equal;
+            }
+
+            copies.erase(copy);
+        }
+
+        // replace the value of the entry, an ordered entry is moved to the
+        // position of its new value. The new value is equal to the old by the
+        // unique predicate so has the same unique hash.
+        const value_type &replaceValue(store_iterator itr, value_type value)
+        {
+            if constexpr(ordered_)
+            {
+                auto index_itr = findIndex(itr);
+                auto node = store_.extract(itr);
+                node.value().value_ = std::move(value);
+
+                auto moved = store_.insert(std::move(node));
+                index_itr->second = moved;
+                return moved->value_;
+            }
+            else
+            {
+                auto slot = store_.erase(itr, itr);
+                slot->value_ = std::move(value);
+                return slot->value_;
+            }
+        }
+
+        void removeEntry(store_iterator itr)
+        {
+            if constexpr(hash_indexed_)
+                index_.erase(findIndex(itr));
+
+            store_.erase(itr);
+        }
+
+        // an element has been added to the results
+        void addToResults(const value_type &value)
+        {
+            ++size_;
+            std::apply([&value](auto& ...states) { (states.insert(value), ...); }, aggregates_);
+        }
+
+        // an element has been removed from the results
+        void removeFromResults(const value_type &value)
+        {
+            --size_;
+            std::apply([&value](auto& ...states) { (states.erase(value), ...); }, aggregates_);
+        }
+    };
+
+    // one query of a processLinqBatch, the operations, without a from, to
+    // process over the shared source
+    template<typename ...TArgs>
+    struct query
+    {
+        std::tuple<TArgs...> operations_;
+
+        query(TArgs ...operations)
+            :operations_(std::move(operations)...)
+        { }
+    };
+
+    // compile time plan of a query in a batch
+    template<typename ...TArgs>
+    struct batchPlan
+    {
+        static constexpr size_t count_ = sizeof...(TArgs);
+
+        // the wheres tested during the shared scan, those before any other
+        // processing operation. A cancelWhen and a memoryBudget are checked
+        // during the scan as well so do not end the leading wheres.
+        static constexpr std::array<bool, count_> streamed()
+        {
+            constexpr std::array<std::string_view, count_> names = {TArgs::operation...};
+
+            std::array<bool, count_> results{};
+            bool leading = true;
+            for(size_t index = 0; index < count_; ++index)
+            {
+                if(names[index] == where_name())
+                    results[index] = leading;
+                else if(names[index] != extract_name() && names[index] != to_collection_name() &&
+                        names[index] != aggregate_name() && names[index] != cancellation_name() &&
+                        names[index] != memory_budget_name())
+                    leading = false;
+            }
+
+            return results;
+        }
+
+        // the number of operations processed after the scan
+        static constexpr size_t remaining()
+        {
+            constexpr auto wheres = streamed();
+
+            size_t count = 0;
+            for(size_t index = 0; index < count_; ++index)
+                count += wheres[index] ? 0 : 1;
+
+            return count;
+        }
+
+        // the query is only streamed wheres and aggregates, no elements need
+        // to be kept
+        static constexpr bool aggregates()
+        {
+            constexpr auto wheres = streamed();
+            constexpr std::array<std::string_view, count_> names = {TArgs::operation...};
+
+            bool found = false;
+            for(size_t index = 0; index < count_; ++index)
+            {
+                if(names[index] == aggregate_name())
+                    found = true;
+                else if(!wheres[index])
+                    return false;
+            }
+
+            return found;
+        }
+
+        // the query is only streamed wheres and an extract, the extracted
+        // values are kept instead of the elements
+        static constexpr bool extractOnly()
+        {
+            constexpr auto wheres = streamed();
+            constexpr std::array<std::string_view, count_> names = {TArgs::operation...};
+
+            bool found = false;
+            for(size_t index = 0; index < count_; ++index)
+            {
+                if(names[index] == extract_name())
+                    found = true;
+                else if(!wheres[index])
+                    return false;
+            }
+
+            return found;
+        }
+    };
+
+    // the initial scan state of a batch query, the aggregate states, the
+    // extracted values or the elements kept
+    template<typename VT, typename ...TArgs>
+    auto batchState(const TArgs& ...operations)
+    {
+        using plan = batchPlan<TArgs...>;
+
+        if constexpr(plan::aggregates())
+        {
+            return std::apply([](const auto& ...aggregate_ops) {
+                                  return std::make_tuple(aggregate_ops.template scanState<VT>()...);
+                              }, findAllOperations(aggregate_name, operations...));
+        }
+        else if constexpr(plan::extractOnly())
+        {
+            auto extract_op = findOperation(extract_name, operations...);
+            return std::vector<std::decay_t<decltype(extract_op.extract_operation_(std::declval<const VT&>()))>>{};
         }
         else
         {
-            return process_results;
+            return std::vector<VT>{};
+        }
+    }
+
+    // the scan state of one query of a batch, the streamed wheres are tested
+    // as each source element is given and the passing elements are kept, or
+    // their extracted values or aggregates, for the rest of the operations.
+    // The cancellation, if the query has one, is checked after each chunk of
+    // source elements and each element kept is checked against the memory
+    // budget, if it has one, before it is added.
+    template<typename VT, typename ...TArgs>
+    class batchScan
+    {
+    public:
+        using plan = batchPlan<TArgs...>;
+
+        batchScan(std::tuple<TArgs...> operations)
+            :operations_(std::move(operations)),
+             state_(std::apply([](const auto& ...operations) { return batchState<VT>(operations...); }, operations_)),
+             append_(makeStageAppend(operations_, where_name()))
+        {
+            validateOperations<TArgs...>();
+
+            static_assert(numberOfNamedOperationTypes<TArgs...>(aggregate_name) == 0 || plan::aggregates(),
+                    "A batch query with aggregates can only have where operations before the aggregates");
+
+            // the source is read in place, only the kept elements are held
+            if constexpr(budget_index_ < plan::count_)
+                std::get<budget_index_>(operations_).start(0);
+        }
+
+        // a source element
+        void insert(const VT &value)
+        {
+            if(passes(value, std::make_index_sequence<plan::count_>{}))
+                keep(value);
+
+            if constexpr(cancel_index_ < plan::count_)
+            {
+                if(++scanned_ % cancelWhen::chunk_size_ == 0)
+                    std::get<cancel_index_>(operations_).check();
+            }
+        }
+
+        // the query results once the source is scanned, the aggregate values
+        // in the order given, or the results of processing the rest of the
+        // operations over the kept elements
+        auto results()
+        {
+            if constexpr(cancel_index_ < plan::count_)
+                std::get<cancel_index_>(operations_).check();
+
+            if constexpr(plan::aggregates())
+            {
+                return std::apply([](const auto& ...states) { return std::make_tuple(states.value()...); }, state_);
+            }
+            else if constexpr(plan::extractOnly() || plan::remaining() == 0)
+            {
+                return std::move(state_);
+            }
+            else
+            {
+                return std::apply([this](auto ...operations) {
+                                      return processLinq(from{std::move(state_)}, std::move(operations)...);
+                                  }, remainingOperations(std::make_index_sequence<plan::count_>{}));
+            }
         }
+
+    private:
+        static constexpr auto cancel_index_ = operationIndex<TArgs...>(cancellation_name);
+        static constexpr auto budget_index_ = operationIndex<TArgs...>(memory_budget_name);
+
+        std::tuple<TArgs...> operations_;
+
+        decltype(batchState<VT>(std::declval<const TArgs&>()...)) state_;
+        decltype(makeStageAppend(std::declval<const std::tuple<TArgs...>&>(), where_name())) append_;
+        size_t scanned_ = 0;
+
+        // keep a passing element, or add it to the aggregates
+        void keep(const VT &value)
+        {
+            if constexpr(plan::aggregates())
+            {
+                std::apply([&value](auto& ...states) { (states.insert(value), ...); }, state_);
+            }
+            else if constexpr(plan::extractOnly())
+            {
+                auto extract_op = std::apply([](const auto& ...operations) {
+                                                 return findOperation(extract_name, operations...);
+                                             }, operations_);
+                append_.appendNew(state_, extract_op.extract_operation_(value));
+            }
+            else
+            {
+                append_(state_, value);
+            }
+        }
+
+        template<size_t I>
+        bool test(const VT &value) const
+        {
+            if constexpr(plan::streamed()[I])
+                return std::get<I>(operations_).where_operation_(value);
+            else
+                return true;
+        }
+
+        template<size_t... Is>
+        bool passes(const VT &value, std::index_sequence<Is...>) const
+        {
+            return (... && test<Is>(value));
+        }
+
+        // the operations not processed during the scan
+        template<size_t... Is>
+        auto remainingOperations(std::index_sequence<Is...>)
+        {
+            return std::tuple_cat([this]() {
+                                      if constexpr(plan::streamed()[Is])
+                                          return std::tuple<>{};
+                                      else
+                                          return std::make_tuple(std::move(std::get<Is>(operations_)));
+                                  }()...);
+        }
+    };
+
+    template<typename VT, typename ...TArgs>
+    auto makeBatchScan(query<TArgs...> &&query_op)
+    {
+        return batchScan<VT, TArgs...>{std::move(query_op.operations_)};
+    }
+
+    // processLinqBatch
+    // processes each of the given queries over the source in one shared pass,
+    // the source is read once in place, not copied through a from, and each
+    // element is given to every query. The wheres at the start of each query
+    // are tested during the pass so only the passing elements are kept, or
+    // only their extracted values when the query is wheres and an extract,
+    // or only running aggregates (sumOf, minOf, maxOf) when the query is
+    // wheres and aggregates. The rest of each query is then processed over
+    // its kept elements. A cancelWhen of a query is checked during the pass
+    // after each chunk of elements and a memoryBudget as each element is
+    // kept, either stops the whole batch. The results are returned as a tuple
+    // in the order the queries were given.
+    template<typename ST, typename ...QT>
+    auto processLinqBatch(const ST &source, QT ...queries)
+    {
+        using value_type = typename ST::value_type;
+
+        auto scans = std::make_tuple(makeBatchScan<value_type>(std::move(queries))...);
+
+        for(const auto &value : source)
+            std::apply([&value](auto& ...scan) { (scan.insert(value), ...); }, scans);
+
+        return std::apply([](auto& ...scan) { return std::make_tuple(scan.results()...); }, scans);
     }
 }
 
@@ -0,0 +1,68 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, extractAndAsFlatHashMap)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                        from{test_data_},
+                        asFlatHashMap{}
+                    );
+
+    auto expected = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                        from{test_data_},
+                        asUnorderedMap{}
+                    );
+
+    // confirm the same keys and values as a std::unordered_map
+    ASSERT_EQ(expected.size(), result.size());
+    for(const auto &[last_name, salary] : expected)
+        EXPECT_DOUBLE_EQ(salary, result.at(last_name));
+
+    EXPECT_DOUBLE_EQ(48380, result.find("Baelish")->second);
+    EXPECT_THROW(result.at("Tully"), std::out_of_range);
+
+    result["Tully"] = 100000;
+    EXPECT_EQ(21, result.size());
+    EXPECT_DOUBLE_EQ(100000, result.at("Tully"));
+    EXPECT_DOUBLE_EQ(48380, result["Baelish"]);
+}
+
+TEST_F(LinqTest, asFlatHashMapFirstOfDuplicateKeys)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.age_ / 10, p.first_name_); }},
+                        from{test_data_},
+                        asFlatHashMap{}
+                    );
+
+    auto expected = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.age_ / 10, p.first_name_); }},
+                        from{test_data_},
+                        asUnorderedMap{}
+                    );
+
+    // of duplicate keys the first is kept, as with a std::unordered_map
+    ASSERT_EQ(expected.size(), result.size());
+    for(const auto &[decade, first_name] : expected)
+        EXPECT_EQ(first_name, result.at(decade));
+}
+
+TEST_F(LinqTest, asFlatHashMapWithoutExtract)
+{
+    std::vector<std::pair<int, std::string>> names{{3, "three"}, {1, "one"}, {2, "two"}, {3, "four"}};
+
+    auto result = processLinq(from{names}, where{[](const auto &name) { return name.first > 1; }}, asFlatHashMap{});
+
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ("two", result.at(2));
+    EXPECT_EQ("three", result.at(3));
+    EXPECT_FALSE(result.contains(1));
+}
@@ -0,0 +1,86 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <random>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, extractAndAsFlatHashSet)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{test_data_},
+                        asFlatHashSet{}
+                    );
+
+    // confirm correct size
+    EXPECT_EQ(20, result.size());
+
+    // the elements are held in the order inserted
+    EXPECT_EQ("Snow", *result.begin());
+    EXPECT_EQ("Frey", *std::prev(result.end()));
+
+    EXPECT_TRUE(result.contains("Stark"));
+    EXPECT_TRUE(result.contains(std::string{"Lannister"}));
+    EXPECT_FALSE(result.contains("Tully"));
+    EXPECT_EQ(result.end(), result.find("Tully"));
+    EXPECT_EQ(1, result.count("Snow"));
+}
+
+TEST_F(LinqTest, flatHashSetMatchesUnorderedSet)
+{
+    std::mt19937 generator{7};
+    std::uniform_int_distribution<int> distribution{0, 50000};
+
+    std::vector<int> int_data(100000);
+    std::generate(int_data.begin(), int_data.end(), [&]() { return distribution(generator); });
+
+    auto result = processLinq(from{int_data}, where{[](int value) { return value % 3 != 0; }}, asFlatHashSet{});
+    auto expected = processLinq(from{int_data}, where{[](int value) { return value % 3 != 0; }}, asUnorderedSet{});
+
+    ASSERT_EQ(expected.size(), result.size());
+    for(int value = -10; value < 50010; ++value)
+        ASSERT_EQ(expected.count(value), result.count(value)) << value;
+}
+
+namespace
+{
+    // every key in the same group, the probing moves on through the groups
+    struct collidingHash
+    {
+        size_t operator()(int) const { return 42; }
+    };
+}
+
+TEST_F(LinqTest, flatHashSetCollisionsAndGrowth)
+{
+    flatHashSet<int, collidingHash> values;
+
+    for(int value = 0; value < 200; ++value)
+        EXPECT_TRUE(values.insert(value).second);
+
+    for(int value = 0; value < 200; ++value)
+        EXPECT_FALSE(values.insert(value).second);
+
+    EXPECT_EQ(200, values.size());
+    EXPECT_TRUE(values.contains(0));
+    EXPECT_TRUE(values.contains(199));
+    EXPECT_FALSE(values.contains(200));
+
+    // sized up front, the elements do not move as the table grows
+    flatHashSet<std::string> names{1000};
+    EXPECT_GE(names.capacity(), 1000);
+    names.insert("Stark");
+
+    auto copy = names;
+    EXPECT_EQ(names, copy);
+
+    names.clear();
+    EXPECT_TRUE(names.empty());
+    EXPECT_FALSE(names.contains("Stark"));
+    EXPECT_TRUE(copy.contains("Stark"));
+}
@@ -0,0 +1,76 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, extractAndAsFlatMap)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                        from{test_data_},
+                        asFlatMap{}
+                    );
+
+    // confirm correct size
+    ASSERT_EQ(20, result.size());
+
+    // confirm data intact
+    EXPECT_EQ("Baelish", result.begin()->first);
+    EXPECT_DOUBLE_EQ(48380, result.begin()->second);
+    EXPECT_EQ("Worm", result.rbegin()->first);
+    EXPECT_DOUBLE_EQ(27500.9, result.rbegin()->second);
+
+    // confirm the lookups
+    EXPECT_DOUBLE_EQ(48380, result.at("Baelish"));
+    EXPECT_THROW(result.at("Tully"), std::out_of_range);
+    EXPECT_EQ(result.end(), result.find("Tully"));
+
+    result["Tully"] = 100000;
+    EXPECT_EQ(21, result.size());
+    EXPECT_DOUBLE_EQ(100000, result.find("Tully")->second);
+}
+
+TEST_F(LinqTest, asFlatMapMatchesAsMap)
+{
+    auto query = [this](auto collection) {
+        return processLinq(
+                        extract{[](const person &p) { return std::make_pair(p.age_ / 10, p.first_name_); }},
+                        from{test_data_},
+                        where{[](const person &p) { return p.salary_ < 50000; }},
+                        orderBy{[](int lhs, int rhs) { return lhs > rhs; }},
+                        collection
+                    );
+    };
+
+    auto result = query(asFlatMap{});
+    auto expected = query(asMap{});
+
+    // of duplicate keys the first is kept, as with a std::map
+    ASSERT_EQ(expected.size(), result.size());
+    EXPECT_TRUE(std::equal(result.begin(), result.end(), expected.begin(),
+                           [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; }));
+    EXPECT_EQ(expected.at(2), result.at(2));
+}
+
+TEST_F(LinqTest, asFlatMapWithoutExtract)
+{
+    std::vector<std::pair<std::string, int>> pairs{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+
+    auto result = processLinq(from{pairs}, asFlatMap{});
+
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ(1, result.at("a"));
+    EXPECT_EQ("c", result.rbegin()->first);
+
+    // a std::map source with const keys
+    std::map<int, std::string> names{{3, "three"}, {1, "one"}, {2, "two"}};
+    auto descending = processLinq(from{names}, orderBy{[](int lhs, int rhs) { return lhs > rhs; }}, asFlatMap{});
+
+    ASSERT_EQ(3, descending.size());
+    EXPECT_EQ(3, descending.begin()->first);
+    EXPECT_EQ("two", descending.at(2));
+}
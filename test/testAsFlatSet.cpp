@@ -0,0 +1,90 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, extractAndAsFlatSet)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{test_data_},
+                        asFlatSet{}
+                    );
+
+    auto expected = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{test_data_},
+                        asSet{}
+                    );
+
+    // confirm the same elements in the same order as a std::set
+    ASSERT_EQ(expected.size(), result.size());
+    EXPECT_TRUE(std::equal(result.begin(), result.end(), expected.begin()));
+    EXPECT_EQ("Baelish", *result.begin());
+    EXPECT_EQ("Worm", *result.rbegin());
+
+    // confirm the binary search lookups
+    EXPECT_TRUE(result.contains("Stark"));
+    EXPECT_FALSE(result.contains("Tully"));
+    EXPECT_EQ(1, result.count("Snow"));
+    EXPECT_EQ("Snow", *result.find("Snow"));
+    EXPECT_EQ(result.end(), result.find("Zzz"));
+    EXPECT_EQ("Snow", *result.lower_bound("Sn"));
+}
+
+TEST_F(LinqTest, asFlatSetWithOrderingAndWhereFilter)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        where{[](const person &p) { return p.salary_ < 30000; }},
+                        orderBy{[](const std::string &lhs, const std::string &rhs) { return lhs > rhs; }},
+                        asFlatSet{}
+                    );
+
+    // confirm correct size
+    ASSERT_EQ(8, result.size());
+
+    // the orderBy predicate orders the set and its lookups
+    EXPECT_EQ("Theon", *result.begin());
+    EXPECT_EQ("Grey", *result.rbegin());
+    EXPECT_TRUE(result.contains("Grey"));
+    EXPECT_FALSE(result.contains("Ned"));
+}
+
+TEST_F(LinqTest, asFlatSetWithoutExtract)
+{
+    std::vector<int> int_data{7,3,9,3,1,7,8,1};
+
+    auto result = processLinq(from{int_data}, asFlatSet{});
+    EXPECT_EQ((std::vector<int>{1,3,7,8,9}), std::vector<int>(result.begin(), result.end()));
+
+    // an orderBy with no predicate uses operator<
+    result = processLinq(from{int_data}, where{[](int value) { return value > 2; }}, orderBy{}, asFlatSet{});
+    EXPECT_EQ((std::vector<int>{3,7,8,9}), std::vector<int>(result.begin(), result.end()));
+
+    auto descending = processLinq(from{int_data}, orderBy{[](int lhs, int rhs) { return lhs > rhs; }}, asFlatSet{});
+    EXPECT_EQ((std::vector<int>{9,8,7,3,1}), std::vector<int>(descending.begin(), descending.end()));
+}
+
+TEST_F(LinqTest, flatSetInsertAndProcessInto)
+{
+    flatSet<std::string> names;
+    EXPECT_TRUE(names.insert("Stark").second);
+    EXPECT_TRUE(names.insert("Arryn").second);
+    EXPECT_FALSE(names.insert("Stark").second);
+
+    // the extracted values are merged with the values already held
+    processLinqInto(names,
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ > 50; }},
+                    cancelWhen{cancellationToken{}});
+
+    EXPECT_EQ((std::vector<std::string>{"Baelish", "Frey", "Mormont", "Seaworth", "Stark"}),
+              std::vector<std::string>(names.begin(), names.end()));
+}
@@ -0,0 +1,119 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <list>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, testSimpleAsList)
+{
+    auto result = processLinq(
+                        from{test_data_},
+                        asList{}
+                    );
+
+    // confirm correct size
+    static_assert(std::is_same_v<std::list<person>, decltype(result)>);
+    ASSERT_EQ(20, result.size());
+
+    // check correct order maintained
+    EXPECT_EQ("John", result.front().first_name_);
+    EXPECT_EQ("Ned", std::next(result.begin())->first_name_);
+    EXPECT_EQ("Walder", result.back().first_name_);
+}
+
+TEST_F(LinqTest, testAsListWithExtract)
+{
+    auto result = processLinq(
+                        extract{[](const person &p){ return p.last_name_; }},
+                        from{test_data_},
+                        where{[](const person &p) { return p.age_ > 50; }},
+                        asList{}
+                    );
+
+    EXPECT_EQ((std::list<std::string>{"Stark", "Baelish", "Mormont", "Seaworth", "Frey"}), result);
+}
+
+TEST_F(LinqTest, listSourceWhereTopBottom)
+{
+    std::list<int> int_data{9,3,7,1,8,2,6,4,5};
+
+    auto result = processLinq(
+                        from{int_data},
+                        where{[](int value) { return value != 8; }},
+                        orderBy{[](int lhs, int rhs) { return lhs > rhs; }},
+                        top{5},
+                        bottom{3},
+                        asList{}
+                    );
+
+    EXPECT_EQ((std::list<int>{6,5,4}), result);
+
+    // numbers greater than the size keep every element
+    result = processLinq(from{int_data}, top{20}, bottom{20});
+    EXPECT_EQ(int_data, result);
+
+    result = processLinq(from{int_data}, top{0});
+    EXPECT_TRUE(result.empty());
+}
+
+namespace
+{
+    struct counted
+    {
+        static inline size_t copies_ = 0;
+
+        int value_;
+
+        counted(int value)
+            :value_(value)
+        { }
+
+        counted(const counted &other)
+            :value_(other.value_)
+        {
+            ++copies_;
+        }
+
+        counted(counted &&) = default;
+        counted &operator=(const counted &) = default;
+        counted &operator=(counted &&) = default;
+
+        bool operator<(const counted &other) const { return value_ < other.value_; }
+    };
+}
+
+TEST_F(LinqTest, listNodesRelinkedNotCopied)
+{
+    std::list<counted> source;
+    for(int value = 0; value < 100; ++value)
+        source.emplace_back(value);
+
+    // the copies made of the source by the processing itself
+    counted::copies_ = 0;
+    processLinq(from{source}, asList{});
+    auto source_copies = counted::copies_;
+
+    counted::copies_ = 0;
+
+    auto result = processLinq(
+                        from{source},
+                        where{[](const counted &c) { return c.value_ % 3 == 0; }},
+                        orderBy{[](const counted &lhs, const counted &rhs) { return rhs < lhs; }},
+                        top{10},
+                        bottom{4},
+                        asList{}
+                    );
+
+    // the where, sort, top, bottom and the conversion relink the nodes, no
+    // copies are made beyond those of the source
+    EXPECT_EQ(source_copies, counted::copies_);
+
+    ASSERT_EQ(4, result.size());
+    EXPECT_EQ(81, result.front().value_);
+    EXPECT_EQ(72, result.back().value_);
+}
@@ -0,0 +1,108 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <memory>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, asSmallVectorHoldsSmallResultsInPlace)
+{
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.salary_ > 50000; }},
+                    top{5},
+                    asSmallVector<8>{}
+                );
+
+    static_assert(std::is_same_v<decltype(result), smallVector<std::string, 8>>);
+
+    EXPECT_EQ((smallVector<std::string, 8>{"Ned", "Daenerys", "Tyrion"}), result);
+
+    // no heap storage was needed for the results
+    EXPECT_TRUE(result.isInline());
+    EXPECT_EQ(0, estimatedAllocatedBytes(result));
+}
+
+TEST_F(LinqTest, asSmallVectorSpillsToHeap)
+{
+    auto expected = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{test_data_},
+                        orderBy{}
+                    );
+
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_},
+                    orderBy{},
+                    asSmallVector<4>{}
+                );
+
+    ASSERT_EQ(20, result.size());
+    EXPECT_FALSE(result.isInline());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), result.begin(), result.end()));
+
+    // without an extract the elements are moved into the smallVector
+    auto people = processLinq(from{test_data_}, where{[](const person &p) { return p.age_ < 18; }}, asSmallVector<4>{});
+    ASSERT_EQ(3, people.size());
+    EXPECT_TRUE(people.isInline());
+    EXPECT_EQ("Podrick", people[0].first_name_);
+}
+
+TEST_F(LinqTest, smallVectorSourceThroughStages)
+{
+    smallVector<int, 16> int_data{9,3,7,1,8,2,6,4,5,3,7};
+
+    // every stage works on the smallVector given as the source
+    auto result = processLinq(
+                    from{int_data},
+                    where{[](int value) { return value > 2; }},
+                    stableUnique{},
+                    orderBy{[](int lhs, int rhs) { return lhs > rhs; }},
+                    top{4},
+                    asSmallVector<16>{}
+                );
+
+    EXPECT_EQ((smallVector<int, 16>{9,8,7,6}), result);
+    EXPECT_TRUE(result.isInline());
+
+    // the source is unchanged
+    EXPECT_EQ(11, int_data.size());
+}
+
+TEST_F(LinqTest, smallVectorCopyAndMove)
+{
+    smallVector<std::unique_ptr<int>, 2> pointers;
+    for(int value = 0; value < 3; ++value)
+        pointers.push_back(std::make_unique<int>(value));
+
+    // the heap storage is taken over by a move
+    auto heap_data = pointers.data();
+    auto moved = std::move(pointers);
+    EXPECT_EQ(heap_data, moved.data());
+    EXPECT_TRUE(pointers.empty());
+
+    auto result = processLinq(
+                    from{std::move(moved)},
+                    where{[](const std::unique_ptr<int> &value) { return *value != 1; }},
+                    asSmallVector<2>{}
+                );
+
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(0, *result[0]);
+    EXPECT_EQ(2, *result[1]);
+
+    smallVector<std::string, 2> names{"Jon", "Arya"};
+    auto copy = names;
+    copy.erase(copy.begin());
+    copy.emplace_back(copy.back());
+
+    EXPECT_EQ((smallVector<std::string, 2>{"Arya", "Arya"}), copy);
+    EXPECT_EQ((smallVector<std::string, 2>{"Jon", "Arya"}), names);
+    EXPECT_TRUE(copy.isInline());
+}
@@ -0,0 +1,135 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    std::vector<int> shuffledData(size_t size)
+    {
+        std::vector<int> data(size);
+        std::iota(data.begin(), data.end(), 0);
+        std::shuffle(data.begin(), data.end(), std::mt19937{7});
+        return data;
+    }
+}
+
+TEST_F(LinqTest, cancellationChunkedResultsUnchanged)
+{
+    auto int_data = shuffledData(50000);
+    cancellationToken token;
+
+    auto expected = processLinq(
+                    extract{[](int value) { return value * 2; }},
+                    from{int_data},
+                    where{[](int value) { return value % 3 != 0; }},
+                    orderBy{}
+                );
+
+    auto result = processLinq(
+                    extract{[](int value) { return value * 2; }},
+                    from{int_data},
+                    where{[](int value) { return value % 3 != 0; }},
+                    orderBy{},
+                    cancelWhen{token, std::chrono::minutes{10}}
+                );
+
+    EXPECT_EQ(expected, result);
+    EXPECT_TRUE(std::is_sorted(result.begin(), result.end()));
+}
+
+TEST_F(LinqTest, cancelledBeforeProcessing)
+{
+    cancellationToken token;
+    token.cancel();
+
+    EXPECT_THROW(processLinq(from{test_data_},
+                             where{[](const person &p) { return p.age_ < 30; }},
+                             cancelWhen{token}),
+                 queryCancelled);
+
+    // a deadline already passed
+    EXPECT_THROW(processLinq(from{test_data_},
+                             orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                             cancelWhen{std::chrono::steady_clock::now() - std::chrono::seconds{1}}),
+                 queryDeadlineExceeded);
+}
+
+TEST_F(LinqTest, cancelledAtChunkBoundary)
+{
+    auto int_data = shuffledData(100000);
+    cancellationToken token;
+    size_t tested = 0;
+
+    // cancel part way through the first chunk
+    EXPECT_THROW(processLinq(from{int_data},
+                             where{[&](int value) {
+                                 if(++tested == 1000)
+                                     token.cancel();
+                                 return value > 10;
+                             }},
+                             cancelWhen{token}),
+                 queryCancelled);
+
+    // the where stopped at the end of the chunk
+    EXPECT_EQ(cancelWhen::chunk_size_, tested);
+}
+
+TEST_F(LinqTest, processAsyncResults)
+{
+    auto future = processLinqAsync(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ < 18; }},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}
+                );
+
+    EXPECT_EQ((std::vector<std::string>{"Ser", "Meera", "Podrick"}), future.get());
+}
+
+TEST_F(LinqTest, processAsyncCancelledAndDeadline)
+{
+    auto int_data = shuffledData(200000);
+    cancellationToken token;
+    std::atomic<bool> started{false};
+
+    auto cancelled = processLinqAsync(
+                    from{int_data},
+                    where{[&](int value) {
+                        started = true;
+                        std::this_thread::sleep_for(std::chrono::microseconds{1});
+                        return value > 10;
+                    }},
+                    cancelWhen{token}
+                );
+
+    while(!started)
+        std::this_thread::yield();
+    token.cancel();
+
+    EXPECT_THROW(cancelled.get(), queryCancelled);
+
+    // a slow query abandoned at its deadline
+    auto start = std::chrono::steady_clock::now();
+    auto timed = processLinqAsync(
+                    from{int_data},
+                    where{[](int value) {
+                        std::this_thread::sleep_for(std::chrono::microseconds{1});
+                        return value > 10;
+                    }},
+                    cancelWhen{std::chrono::milliseconds{20}}
+                );
+
+    EXPECT_THROW(timed.get(), queryDeadlineExceeded);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{5});
+}
@@ -0,0 +1,236 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <filesystem>
+#include <sstream>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    // temporary directory for the sort runs, removed with the test
+    struct tempDirectory
+    {
+        std::filesystem::path path_;
+
+        tempDirectory()
+            :path_(std::filesystem::temp_directory_path() / 
+                   ("linqcpp_external_sort_test_" + std::to_string(std::random_device{}())))
+        {
+            std::filesystem::create_directories(path_);
+        }
+
+        ~tempDirectory()
+        {
+            std::filesystem::remove_all(path_);
+        }
+
+        bool empty() const
+        {
+            return std::filesystem::is_empty(path_);
+        }
+    };
+
+    std::vector<int> generateValues(size_t count)
+    {
+        std::vector<int> values;
+        uint32_t state = 987654321;
+        for(size_t i = 0; i < count; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            values.push_back(static_cast<int>(state >> 8) - (1 << 23));
+        }
+
+        return values;
+    }
+
+    // writes a person as length prefixed strings followed by age and salary
+    struct personSerializer
+    {
+        void write(std::ostream &out, const LinqTest::person &p) const
+        {
+            writeString(out, p.first_name_);
+            writeString(out, p.last_name_);
+            out.write(reinterpret_cast<const char *>(&p.age_), sizeof(p.age_));
+            out.write(reinterpret_cast<const char *>(&p.salary_), sizeof(p.salary_));
+        }
+
+        bool read(std::istream &in, LinqTest::person &p) const
+        {
+            return readString(in, p.first_name_) && readString(in, p.last_name_) &&
+                   in.read(reinterpret_cast<char *>(&p.age_), sizeof(p.age_)) &&
+                   in.read(reinterpret_cast<char *>(&p.salary_), sizeof(p.salary_));
+        }
+
+        static void writeString(std::ostream &out, const std::string &value)
+        {
+            auto size = value.size();
+            out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            out.write(value.data(), size);
+        }
+
+        static bool readString(std::istream &in, std::string &value)
+        {
+            size_t size = 0;
+            if(!in.read(reinterpret_cast<char *>(&size), sizeof(size)))
+                return false;
+
+            value.resize(size);
+            return static_cast<bool>(in.read(value.data(), size));
+        }
+    };
+}
+
+TEST_F(LinqTest, externalSortThenQuery)
+{
+    tempDirectory temp_directory;
+    auto data = generateValues(1000);
+
+    // the data streams through runs of 16 into the results, the query then
+    // runs over the sorted results
+    std::vector<int> sorted;
+    externalSort{16 * sizeof(int), temp_directory.path_}.sort(data.begin(), data.end(),
+                                                               std::back_inserter(sorted), std::less<>{});
+
+    auto result = processLinq(from{std::move(sorted)}, where{[](int value) { return value % 2 == 0; }});
+
+    auto expected = processLinq(from{data}, where{[](int value) { return value % 2 == 0; }}, orderBy{});
+
+    EXPECT_EQ(expected, result);
+    EXPECT_TRUE(temp_directory.empty());
+}
+
+TEST_F(LinqTest, externalSortMultipleMergePasses)
+{
+    tempDirectory temp_directory;
+    auto data = generateValues(2000);
+
+    externalSort sort_op{10 * sizeof(int), temp_directory.path_};
+    sort_op.merge_fan_in_ = 4;
+
+    // runs of at most 10 ints, including the growth of the run, merged 4 at
+    // a time
+    std::vector<int> result;
+    sort_op.sort(data.begin(), data.end(), std::back_inserter(result), std::greater<>{});
+
+    auto expected = data;
+    std::sort(expected.begin(), expected.end(), std::greater<>{});
+
+    EXPECT_EQ(expected, result);
+
+    // run files removed
+    EXPECT_TRUE(temp_directory.empty());
+}
+
+TEST_F(LinqTest, externalSortWithSerializer)
+{
+    tempDirectory temp_directory;
+
+    // runs of 3 people written through the serializer
+    std::vector<person> sorted;
+    externalSort{3 * sizeof(person), temp_directory.path_, personSerializer{}}.sort(
+                        test_data_.begin(), test_data_.end(), std::back_inserter(sorted),
+                        [](const person &lhs, const person &rhs) { return lhs.first_name_ < rhs.first_name_; });
+
+    auto result = processLinq(extract{[](const person &p) { return p.first_name_; }}, from{sorted});
+
+    auto expected = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.first_name_ < rhs.first_name_; }}
+                    );
+
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ("Daenerys", result.front());
+    EXPECT_TRUE(temp_directory.empty());
+}
+
+namespace
+{
+    // writes strings length prefixed, counting the runs read to their end
+    struct countingStringSerializer
+    {
+        size_t *runs_ended_;
+
+        void write(std::ostream &out, const std::string &value) const
+        {
+            auto size = value.size();
+            out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            out.write(value.data(), size);
+        }
+
+        bool read(std::istream &in, std::string &value) const
+        {
+            size_t size = 0;
+            if(!in.read(reinterpret_cast<char *>(&size), sizeof(size)))
+            {
+                ++*runs_ended_;
+                return false;
+            }
+
+            value.resize(size);
+            return static_cast<bool>(in.read(value.data(), size));
+        }
+    };
+}
+
+TEST_F(LinqTest, externalSortBudgetCountsOwnedStorage)
+{
+    tempDirectory temp_directory;
+
+    std::vector<std::string> text_data;
+    for(int value = 0; value < 20; ++value)
+        text_data.push_back(std::string(1000, static_cast<char>('a' + (value * 7) % 20)));
+
+    // the string storage, not the sizeof the strings, fills the runs, so at
+    // most 4 strings fit in each run
+    size_t runs_ended = 0;
+    std::vector<std::string> sorted;
+    externalSort{4500, temp_directory.path_, countingStringSerializer{&runs_ended}}.sort(
+                        text_data.begin(), text_data.end(), std::back_inserter(sorted), std::less<>{});
+
+    auto expected = text_data;
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(expected, sorted);
+    EXPECT_GE(runs_ended, 5);
+    EXPECT_TRUE(temp_directory.empty());
+}
+
+TEST_F(LinqTest, externalSortStreaming)
+{
+    tempDirectory temp_directory;
+
+    // stream from an input stream into an output stream
+    std::istringstream input{"5 3 9 1 7 3 8 2 6 4 0"};
+    std::ostringstream output;
+
+    externalSort{4 * sizeof(int), temp_directory.path_}.sort(
+                        std::istream_iterator<int>{input}, std::istream_iterator<int>{},
+                        std::ostream_iterator<int>{output, " "}, std::less<>{});
+
+    EXPECT_EQ("0 1 2 3 3 4 5 6 7 8 9 ", output.str());
+    EXPECT_TRUE(temp_directory.empty());
+
+    // within budget nothing is written to disk
+    std::vector<int> small_data{3, 1, 2};
+    std::vector<int> small_result;
+    externalSort{1024, temp_directory.path_ / "missing"}.sort(small_data.begin(), small_data.end(),
+                                                              std::back_inserter(small_result), std::less<>{});
+
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), small_result);
+}
+
+TEST_F(LinqTest, externalSortUnwritableDirectory)
+{
+    auto data = generateValues(100);
+
+    std::vector<int> result;
+    EXPECT_THROW(externalSort(8 * sizeof(int), std::filesystem::path{"/nonexistent/linqcpp"}).sort(
+                        data.begin(), data.end(), std::back_inserter(result), std::less<>{}),
+                 std::runtime_error);
+}
@@ -0,0 +1,230 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <numeric>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, viewWhereAndOrderByMatchesProcessLinq)
+{
+    materializedView view{from{test_data_},
+                          where{[](const person &p) { return p.age_ < 30; }},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}};
+
+    auto expected = processLinq(from{test_data_},
+                                where{[](const person &p) { return p.age_ < 30; }},
+                                orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }});
+
+    // confirm the initial results match a full query
+    EXPECT_EQ(9, view.size());
+    EXPECT_EQ(expected, view.results());
+
+    // filtered out element is ignored
+    EXPECT_FALSE(view.insert({"Robert", "Baratheon", 45, 90000.00}));
+    EXPECT_EQ(9, view.size());
+
+    // inserted element is placed by the ordering
+    EXPECT_TRUE(view.insert({"Arya", "Stark", 11, 100.00}));
+    EXPECT_EQ(10, view.size());
+    EXPECT_EQ("Ser", view.begin()->first_name_);
+    EXPECT_EQ("Arya", std::next(view.begin())->first_name_);
+
+    // erase the youngest
+    EXPECT_TRUE(view.erase({"Ser", "Pounce", 5, 1010.00}));
+    EXPECT_EQ(9, view.size());
+    EXPECT_EQ("Arya", view.begin()->first_name_);
+
+    // erase of element not in the view
+    EXPECT_FALSE(view.erase({"Jon", "Connington", 25, 100.00}));
+    EXPECT_EQ(9, view.size());
+}
+
+TEST_F(LinqTest, viewStableUniqueCountsMembership)
+{
+    std::vector<int> int_data{3,1,2,3,1,2};
+
+    materializedView view{from{int_data}, stableUnique{}};
+
+    // duplicates held once in first insert order
+    EXPECT_EQ((std::vector<int>{3,1,2}), view.results());
+
+    // removing one copy keeps the element
+    view.erase(3);
+    EXPECT_EQ((std::vector<int>{3,1,2}), view.results());
+
+    // removing the last copy removes the element
+    view.erase(3);
+    EXPECT_EQ((std::vector<int>{1,2}), view.results());
+
+    view.insert(4);
+    view.insert(3);
+    EXPECT_EQ((std::vector<int>{1,2,4,3}), view.results());
+}
+
+TEST_F(LinqTest, viewWithoutUniqueKeepsEveryCopy)
+{
+    std::vector<int> int_data{5,4,5};
+
+    materializedView view{from{int_data}, orderBy{[](int lhs, int rhs) { return lhs > rhs; }}};
+
+    EXPECT_EQ((std::vector<int>{5,5,4}), view.results());
+
+    std::vector<int> inserted{6,4};
+    view.insert(inserted.begin(), inserted.end());
+    EXPECT_EQ((std::vector<int>{6,5,5,4,4}), view.results());
+
+    view.erase(5);
+    EXPECT_EQ((std::vector<int>{6,5,4,4}), view.results());
+    EXPECT_EQ(4, view.size());
+}
+
+TEST_F(LinqTest, viewPreSortUniqueMatchesQuery)
+{
+    std::vector<int> int_data{3,1,3,2,1};
+
+    // ordered so equal elements are adjacent, as they are in the query
+    materializedView view{from{int_data}, orderBy{}, preSortUnique{}};
+
+    EXPECT_EQ(processLinq(from{int_data}, orderBy{}, preSortUnique{}), view.results());
+
+    view.erase(3);
+    EXPECT_EQ((std::vector<int>{1,2,3}), view.results());
+
+    view.erase(3);
+    EXPECT_EQ((std::vector<int>{1,2}), view.results());
+}
+
+TEST_F(LinqTest, viewRunningAggregates)
+{
+    materializedView view{from{test_data_},
+                          where{[](const person &p) { return p.salary_ < 30000; }},
+                          sumOf{[](const person &p) { return p.salary_; }},
+                          minOf{[](const person &p) { return p.age_; }},
+                          maxOf{[](const person &p) { return p.age_; }}};
+
+    EXPECT_EQ(8, view.size());
+    EXPECT_DOUBLE_EQ(131289.02, view.aggregate<0>());
+    EXPECT_EQ(5, *view.aggregate<1>());
+    EXPECT_EQ(31, *view.aggregate<2>());
+
+    // erase the minimum and the maximum
+    view.erase({"Ser", "Pounce", 5, 1010.00});
+    view.erase({"Jagen", "H'ghar", 31, 15080.00});
+    EXPECT_DOUBLE_EQ(115199.02, view.aggregate<0>());
+    EXPECT_EQ(14, *view.aggregate<1>());
+    EXPECT_EQ(30, *view.aggregate<2>());
+
+    view.insert({"Hodor", "Hodor", 40, 500.00});
+    EXPECT_DOUBLE_EQ(115699.02, view.aggregate<0>());
+    EXPECT_EQ(40, *view.aggregate<2>());
+}
+
+TEST_F(LinqTest, viewEmptyAggregates)
+{
+    std::vector<int> int_data;
+
+    materializedView view{from{int_data}, stableUnique{}, minOf{[](int value) { return value; }}};
+
+    EXPECT_TRUE(view.empty());
+    EXPECT_FALSE(view.aggregate<0>().has_value());
+
+    view.insert(7);
+    view.insert(7);
+    EXPECT_EQ(7, *view.aggregate<0>());
+
+    view.erase(7);
+    EXPECT_EQ(7, *view.aggregate<0>());
+
+    view.erase(7);
+    EXPECT_FALSE(view.aggregate<0>().has_value());
+}
+
+TEST_F(LinqTest, viewUniquePredicateWithDifferentOrdering)
+{
+    std::vector<person> people{{"Jon", "Snow", 20, 100.00},
+                               {"Ned", "Stark", 50, 300.00},
+                               {"Aemon", "Snow", 90, 200.00},
+                               {"Arya", "Stark", 11, 400.00}};
+
+    // unique by last name, ordered by age
+    materializedView view{from{people},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                          stableUnique{[](const person &lhs, const person &rhs) { return lhs.last_name_ == rhs.last_name_; },
+                                       [](const person &p) { return std::hash<std::string>{}(p.last_name_); }},
+                          sumOf{[](const person &p) { return p.salary_; }}};
+
+    // the first of each last name is kept
+    ASSERT_EQ(2, view.size());
+    EXPECT_EQ("Jon", view.begin()->first_name_);
+    EXPECT_EQ("Ned", std::next(view.begin())->first_name_);
+    EXPECT_DOUBLE_EQ(400.00, view.aggregate<0>());
+
+    // erasing a later copy leaves the results unchanged
+    EXPECT_TRUE(view.erase({"Arya", "Stark", 11, 400.00}));
+    ASSERT_EQ(2, view.size());
+    EXPECT_EQ("Ned", std::next(view.begin())->first_name_);
+    EXPECT_DOUBLE_EQ(400.00, view.aggregate<0>());
+}
+
+TEST_F(LinqTest, viewEraseFirstCopyKeepsNextCopy)
+{
+    std::vector<person> people{{"Jon", "Snow", 20, 100.00},
+                               {"Ned", "Stark", 50, 300.00},
+                               {"Aemon", "Snow", 90, 200.00}};
+
+    materializedView view{from{people},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                          stableUnique{[](const person &lhs, const person &rhs) { return lhs.last_name_ == rhs.last_name_; },
+                                       [](const person &p) { return std::hash<std::string>{}(p.last_name_); }},
+                          sumOf{[](const person &p) { return p.salary_; }}};
+
+    // the surviving Snow takes the place of the erased one, in its own order
+    EXPECT_TRUE(view.erase({"Jon", "Snow", 20, 100.00}));
+    ASSERT_EQ(2, view.size());
+    EXPECT_EQ("Ned", view.begin()->first_name_);
+    EXPECT_EQ("Aemon", std::next(view.begin())->first_name_);
+    EXPECT_DOUBLE_EQ(500.00, view.aggregate<0>());
+
+    // the last copy removes the last name
+    EXPECT_TRUE(view.erase({"Aemon", "Snow", 90, 200.00}));
+    ASSERT_EQ(1, view.size());
+    EXPECT_DOUBLE_EQ(300.00, view.aggregate<0>());
+
+    // without an orderBy the next copy keeps the first copy's position
+    std::vector<int> int_data{11, 5, 21};
+    materializedView unordered{from{int_data}, stableUnique{[](int lhs, int rhs) { return lhs % 10 == rhs % 10; },
+                                                                    [](int value) { return value % 10; }}};
+    EXPECT_EQ((std::vector<int>{11, 5}), unordered.results());
+
+    unordered.erase(11);
+    EXPECT_EQ((std::vector<int>{21, 5}), unordered.results());
+}
+
+TEST_F(LinqTest, viewUniqueHashFindsEntriesAcrossManyResults)
+{
+    std::vector<int> int_data(200000);
+    std::iota(int_data.begin(), int_data.end(), 0);
+
+    // unique by value / 2 ordered descending, each pair of values is one
+    // result found through the unique hash rather than a search of the results
+    materializedView view{from{int_data},
+                          orderBy{[](int lhs, int rhs) { return lhs > rhs; }},
+                          stableUnique{[](int lhs, int rhs) { return lhs / 2 == rhs / 2; },
+                                       [](int value) { return std::hash<int>{}(value / 2); }}};
+
+    ASSERT_EQ(100000, view.size());
+    EXPECT_EQ(199998, *view.begin());
+
+    // erasing the first of a pair replaces it with the second
+    EXPECT_TRUE(view.erase(199998));
+    EXPECT_EQ(100000, view.size());
+    EXPECT_EQ(199999, *view.begin());
+
+    EXPECT_TRUE(view.erase(199999));
+    EXPECT_EQ(99999, view.size());
+    EXPECT_EQ(199996, *view.begin());
+}
@@ -0,0 +1,280 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <numeric>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    // 10000 values each given twice
+    std::vector<int> duplicatedData()
+    {
+        std::vector<int> data(20000);
+        for(size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<int>((i * 7919) % 10000);
+
+        return data;
+    }
+}
+
+TEST_F(LinqTest, budgetReportsPeak)
+{
+    memoryUsage usage;
+
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ < 30; }},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    memoryBudget{1 << 20, usage}
+                );
+
+    EXPECT_EQ(9, result.size());
+
+    // the source, the where results and the extracted names held together
+    EXPECT_GE(usage.peak_bytes_, test_data_.capacity() * sizeof(person) + 9 * sizeof(person));
+    EXPECT_LE(usage.peak_bytes_, size_t{1 << 20});
+    EXPECT_TRUE(usage.spilled_.empty());
+}
+
+TEST_F(LinqTest, budgetFailsFastBeforeUnique)
+{
+    auto int_data = duplicatedData();
+    memoryUsage usage;
+
+    // room for the source but not the hash set of the unique values
+    try
+    {
+        processLinq(from{int_data}, stableUnique{}, memoryBudget{200000, usage});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("stable_unique", exceeded.operation_);
+        EXPECT_GT(exceeded.required_bytes_, exceeded.budget_bytes_);
+        EXPECT_EQ(200000, exceeded.budget_bytes_);
+    }
+
+    // the source alone is over the budget
+    EXPECT_THROW(processLinq(from{int_data}, memoryBudget{1000}), memoryBudgetExceeded);
+}
+
+TEST_F(LinqTest, budgetSpillsUnique)
+{
+    auto int_data = duplicatedData();
+    memoryUsage usage;
+
+    auto expected = processLinq(from{int_data}, stableUnique{});
+    auto result = processLinq(from{int_data}, stableUnique{}, memoryBudget{200000, usage, budget_policy::spill});
+
+    // the first of each value in the order given
+    ASSERT_EQ(10000, result.size());
+    EXPECT_EQ(expected, result);
+
+    ASSERT_EQ(1, usage.spilled_.size());
+    EXPECT_EQ("stable_unique", usage.spilled_[0]);
+    EXPECT_LE(usage.peak_bytes_, 200000);
+}
+
+TEST_F(LinqTest, budgetConversionAndWhere)
+{
+    // the map nodes do not fit
+    EXPECT_THROW(processLinq(extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                             from{test_data_},
+                             asMap{},
+                             memoryBudget{test_data_.capacity() * sizeof(person) + 100}),
+                 memoryBudgetExceeded);
+
+    // a where is checked as each element is added, keeping every element is
+    // too much and it stops before going over
+    memoryUsage usage;
+    auto budget_bytes = test_data_.capacity() * sizeof(person) + 4 * sizeof(person);
+    try
+    {
+        processLinq(from{test_data_},
+                    where{[](const person &) { return true; }},
+                    memoryBudget{budget_bytes, usage});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("where", exceeded.operation_);
+    }
+
+    EXPECT_LE(usage.peak_bytes_, budget_bytes);
+
+    // a where keeping few elements fits
+    auto result = processLinq(from{test_data_},
+                              where{[](const person &p) { return p.age_ > 70; }},
+                              memoryBudget{test_data_.capacity() * sizeof(person) + sizeof(person)});
+
+    EXPECT_EQ(1, result.size());
+}
+
+TEST_F(LinqTest, budgetChecksSourceReadInPlace)
+{
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    // the source is not counted, the lookup results are
+    memoryUsage usage;
+    auto result = processLinq(from{age_index.source()},
+                              where{age_index.atLeast(0)},
+                              memoryBudget{test_data_.size() * sizeof(person), usage});
+
+    EXPECT_EQ(20, result.size());
+    EXPECT_EQ(estimatedAllocatedBytes(result), usage.peak_bytes_);
+
+    // the lookup results do not fit
+    try
+    {
+        processLinq(from{age_index.source()},
+                    where{age_index.atLeast(0)},
+                    memoryBudget{10 * sizeof(person)});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("where", exceeded.operation_);
+    }
+
+    // nor does an in place where keeping every element
+    EXPECT_THROW(processLinq(from{age_index.source()},
+                             where{[](const person &) { return true; }},
+                             memoryBudget{10 * sizeof(person)}),
+                 memoryBudgetExceeded);
+
+    // a source copied for an orderBy is checked before it is copied
+    try
+    {
+        processLinq(from{age_index.source()},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    memoryBudget{10 * sizeof(person)});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("from", exceeded.operation_);
+    }
+}
+
+namespace
+{
+    // a record reporting the heap storage of its long text
+    struct note
+    {
+        int id_;
+        std::string text_;
+
+        size_t ownedBytes() const { return linqcpp::ownedBytes(text_); }
+
+        bool operator==(const note &rhs) const { return id_ == rhs.id_ && text_ == rhs.text_; }
+    };
+}
+
+TEST_F(LinqTest, budgetCountsStorageOwnedByElements)
+{
+    std::vector<std::string> text_data;
+    for(int value = 0; value < 100; ++value)
+        text_data.push_back(std::string(1000, static_cast<char>('a' + value % 26)) + std::to_string(value));
+
+    // the container storage fits, the characters of the strings do not
+    auto container_bytes = text_data.capacity() * sizeof(std::string);
+    EXPECT_THROW(processLinq(from{text_data}, memoryBudget{container_bytes + 1000}), memoryBudgetExceeded);
+
+    memoryUsage usage;
+    auto result = processLinq(from{text_data}, stableUnique{}, memoryBudget{1 << 20, usage});
+
+    EXPECT_EQ(100, result.size());
+    EXPECT_GE(usage.peak_bytes_, container_bytes + 100 * 1000);
+
+    // short strings are held in place and own no storage
+    EXPECT_EQ(0, ownedBytes(std::string{"Jon"}));
+
+    // records report their own storage, the map values are counted
+    std::vector<note> notes{{1, std::string(5000, 'x')}, {2, std::string(5000, 'y')}};
+    EXPECT_GE(ownedBytes(notes.front()), 5000);
+
+    try
+    {
+        processLinq(extract{[](const note &n) { return std::make_pair(n.id_, n); }},
+                    from{notes},
+                    asMap{},
+                    memoryBudget{20000});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("extract", exceeded.operation_);
+    }
+}
+
+namespace
+{
+    // a trivially copyable row much larger than the key extracted from it
+    struct reading
+    {
+        int sensor_;
+        double values_[7];
+    };
+
+    struct sensorOf
+    {
+        int operator()(const reading &r) const { return r.sensor_; }
+    };
+}
+
+TEST_F(LinqTest, budgetSpillsOrderBy)
+{
+    std::vector<reading> readings(20000);
+    for(size_t i = 0; i < readings.size(); ++i)
+        readings[i] = reading{static_cast<int>((i * 7919) % 20000), {}};
+
+    sortedIndex sensor_index{readings, [](const reading &r) { return r.sensor_; }};
+    auto by_sensor = [](const reading &lhs, const reading &rhs) { return lhs.sensor_ > rhs.sensor_; };
+
+    auto expected = processLinq(extract{sensorOf{}}, from{readings}, orderBy{by_sensor});
+
+    // the source is read in place, a copy to order does not fit so it is
+    // sorted in runs and merged into the extracted results
+    memoryUsage usage;
+    auto result = processLinq(extract{sensorOf{}},
+                              from{sensor_index.source()},
+                              orderBy{by_sensor},
+                              memoryBudget{300000, usage, budget_policy::spill});
+
+    EXPECT_EQ(expected, result);
+    ASSERT_EQ(1, usage.spilled_.size());
+    EXPECT_EQ("order_by", usage.spilled_[0]);
+    EXPECT_LE(usage.peak_bytes_, 300000);
+
+    std::deque<int> into_result;
+    processLinqInto(into_result,
+                    extract{sensorOf{}},
+                    from{sensor_index.source()},
+                    orderBy{by_sensor},
+                    memoryBudget{300000, budget_policy::spill});
+
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), into_result.begin(), into_result.end()));
+
+    // a copy that fits is ordered in memory
+    memoryUsage fits_usage;
+    auto fits_result = processLinq(extract{sensorOf{}},
+                                   from{sensor_index.source()},
+                                   orderBy{by_sensor},
+                                   memoryBudget{1 << 22, fits_usage, budget_policy::spill});
+
+    EXPECT_EQ(expected, fits_result);
+    EXPECT_TRUE(fits_usage.spilled_.empty());
+
+    // the extracted results must still fit
+    EXPECT_THROW(processLinq(extract{sensorOf{}},
+                             from{sensor_index.source()},
+                             orderBy{by_sensor},
+                             memoryBudget{20000, budget_policy::spill}),
+                 memoryBudgetExceeded);
+}
@@ -0,0 +1,169 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <memory>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    struct counted
+    {
+        static inline size_t copies_ = 0;
+
+        int value_;
+        std::string name_;
+
+        counted(int value)
+            :value_(value), name_("name " + std::to_string(value))
+        { }
+
+        counted(const counted &other)
+            :value_(other.value_), name_(other.name_)
+        {
+            ++copies_;
+        }
+
+        counted(counted &&) = default;
+        counted &operator=(const counted &other)
+        {
+            value_ = other.value_;
+            name_ = other.name_;
+            ++copies_;
+            return *this;
+        }
+        counted &operator=(counted &&) = default;
+
+        bool operator<(const counted &other) const { return value_ < other.value_; }
+        bool operator==(const counted &other) const { return value_ == other.value_; }
+    };
+
+    std::vector<counted> countedData()
+    {
+        std::vector<counted> data;
+        for(int value = 0; value < 100; ++value)
+            data.emplace_back(value % 40);
+
+        return data;
+    }
+
+    std::vector<std::unique_ptr<int>> pointerData()
+    {
+        std::vector<std::unique_ptr<int>> data;
+        for(int value : {7,3,9,1,8,2,6})
+            data.push_back(std::make_unique<int>(value));
+
+        return data;
+    }
+}
+
+namespace std
+{
+    template<>
+    struct hash<counted>
+    {
+        size_t operator()(const counted &value) const { return std::hash<int>{}(value.value_); }
+    };
+}
+
+TEST_F(LinqTest, moveOnlyElements)
+{
+    auto result = processLinq(
+                    from{pointerData()},
+                    where{[](const std::unique_ptr<int> &p) { return *p > 1; }},
+                    orderBy{[](const std::unique_ptr<int> &lhs, const std::unique_ptr<int> &rhs) { return *lhs > *rhs; }},
+                    top{4},
+                    bottom{3},
+                    asDeque{}
+                );
+
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ(8, *result[0]);
+    EXPECT_EQ(7, *result[1]);
+    EXPECT_EQ(6, *result[2]);
+
+    // the extraction takes the elements as rvalues and moves them on
+    auto values = processLinq(
+                    extract{[](std::unique_ptr<int> &&p) { return std::move(p); }},
+                    from{pointerData()},
+                    stableUnique{},
+                    skip{2},
+                    asList{}
+                );
+
+    ASSERT_EQ(5, values.size());
+    EXPECT_EQ(9, *values.front());
+    EXPECT_EQ(6, *values.back());
+
+    std::vector<std::unique_ptr<int>> into;
+    processLinqInto(into,
+                    from{pointerData()},
+                    where{[](const std::unique_ptr<int> &p) { return *p % 2 == 0; }},
+                    orderBy{[](const std::unique_ptr<int> &lhs, const std::unique_ptr<int> &rhs) { return *lhs < *rhs; }},
+                    optimize{});
+
+    ASSERT_EQ(3, into.size());
+    EXPECT_EQ(2, *into[0]);
+    EXPECT_EQ(8, *into[2]);
+}
+
+TEST_F(LinqTest, moveNoCopiesAfterSource)
+{
+    auto source = countedData();
+    counted::copies_ = 0;
+
+    auto result = processLinq(
+                    from{source},
+                    where{[](const counted &c) { return c.value_ > 5; }},
+                    stableUnique{},
+                    orderBy{[](const counted &lhs, const counted &rhs) { return rhs < lhs; }},
+                    top{10},
+                    bottom{5},
+                    asDeque{}
+                );
+
+    // the source given by lvalue is copied once into the from, no stage or
+    // conversion copies an element
+    EXPECT_EQ(source.size(), counted::copies_);
+
+    ASSERT_EQ(5, result.size());
+    EXPECT_EQ(34, result.front().value_);
+    EXPECT_EQ(30, result.back().value_);
+
+    // a source moved into the from is not copied at all
+    counted::copies_ = 0;
+    auto moved = processLinq(from{std::move(source)}, stableUnique{}, asList{});
+
+    EXPECT_EQ(0, counted::copies_);
+    EXPECT_EQ(40, moved.size());
+}
+
+TEST_F(LinqTest, moveIntoExtractByValue)
+{
+    counted::copies_ = 0;
+
+    // the extraction takes its element by value, the element is moved to it
+    auto names = processLinq(
+                    extract{[](counted c) { return std::move(c.name_); }},
+                    from{countedData()},
+                    where{[](const counted &c) { return c.value_ >= 38; }},
+                    asSet{}
+                );
+
+    EXPECT_EQ(0, counted::copies_);
+    EXPECT_EQ((std::set<std::string>{"name 38", "name 39"}), names);
+
+    // a conversion with no extract moves the elements into the container
+    auto values = processLinq(
+                    from{countedData()},
+                    where{[](const counted &c) { return c.value_ < 3; }},
+                    asUnorderedSet{}
+                );
+
+    EXPECT_EQ(0, counted::copies_);
+    EXPECT_EQ(3, values.size());
+}
@@ -0,0 +1,176 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, optimizeMovesWhereBeforeOrderBy)
+{
+    auto query = [this](auto ...extra) {
+        return processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    where{[](const person &p) { return p.salary_ > 30000; }},
+                    extra...
+                );
+    };
+
+    optimizerReport report;
+    auto optimized = query(optimize{report});
+
+    // confirm the results are unchanged
+    EXPECT_EQ(query(), optimized);
+    ASSERT_EQ(12, optimized.size());
+    EXPECT_EQ("Joffrey", optimized.front());
+    EXPECT_EQ("Walder", optimized.back());
+
+    ASSERT_EQ(1, report.rewrites_.size());
+    EXPECT_EQ("moved where (operation 3) before order_by (operation 2)", report.rewrites_[0]);
+}
+
+TEST_F(LinqTest, optimizeMergesAdjacentWheres)
+{
+    optimizerReport report;
+
+    auto result = processLinq(
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ > 20; }},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.salary_ > rhs.salary_; }},
+                    where{[](const person &p) { return p.age_ < 40; }},
+                    optimize{report}
+                );
+
+    // confirm the results of both predicates
+    ASSERT_EQ(10, result.size());
+    EXPECT_EQ("Tyrion", result.front().first_name_);
+    EXPECT_EQ("Jagen", result.back().first_name_);
+    EXPECT_TRUE(std::is_sorted(result.begin(), result.end(),
+                               [](const person &lhs, const person &rhs) { return lhs.salary_ > rhs.salary_; }));
+
+    ASSERT_EQ(2, report.rewrites_.size());
+    EXPECT_EQ("moved where (operation 3) before order_by (operation 2)", report.rewrites_[0]);
+    EXPECT_EQ("merged where (operation 3) into where (operation 1)", report.rewrites_[1]);
+}
+
+TEST_F(LinqTest, optimizeNeverMovesWhereAcrossTop)
+{
+    optimizerReport report;
+
+    auto result = processLinq(
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    top{5},
+                    where{[](const person &p) { return p.age_ > 15; }},
+                    optimize{report}
+                );
+
+    // the top 5 youngest are taken before the filter
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ("Podrick", result[0].first_name_);
+    EXPECT_EQ("Joffrey", result[1].first_name_);
+    EXPECT_EQ(23, result[2].age_);
+
+    EXPECT_TRUE(report.rewrites_.empty());
+}
+
+TEST_F(LinqTest, optimizeUniqueWithPredicateIsBarrier)
+{
+    std::vector<int> int_data{4,1,9,4,7,1,12};
+
+    optimizerReport report;
+    auto barrier = processLinq(
+                    from{int_data},
+                    stableUnique{[](int lhs, int rhs) { return lhs == rhs; }},
+                    where{[](int value) { return value > 4; }},
+                    optimize{report}
+                );
+
+    EXPECT_EQ((std::vector<int>{9,7,12}), barrier);
+    EXPECT_TRUE(report.rewrites_.empty());
+
+    // the where is moved before a uniqueness with no predicate
+    auto moved = processLinq(
+                    from{int_data},
+                    stableUnique{},
+                    where{[](int value) { return value > 4; }},
+                    optimize{report}
+                );
+
+    EXPECT_EQ((std::vector<int>{9,7,12}), moved);
+    ASSERT_EQ(1, report.rewrites_.size());
+    EXPECT_EQ("moved where (operation 2) before stable_unique (operation 1)", report.rewrites_[0]);
+}
+
+TEST_F(LinqTest, optimizePreSortUniqueOnlyCommutesOnSortedData)
+{
+    std::vector<int> int_data{5,3,5,8,3,3,9};
+
+    // on unsorted data removing the 3 between the 5s makes them adjacent, so
+    // the where is not moved before the preSortUnique
+    optimizerReport report;
+    auto query = [&int_data](auto ...extra) {
+        return processLinq(
+                    from{int_data},
+                    preSortUnique{},
+                    where{[](int value) { return value != 3; }},
+                    extra...
+                );
+    };
+
+    EXPECT_EQ((std::vector<int>{5,5,8,9}), query());
+    EXPECT_EQ(query(), query(optimize{report}));
+    EXPECT_TRUE(report.rewrites_.empty());
+
+    // sorted by operator< first, equal elements stay adjacent after the where
+    auto sorted = processLinq(
+                    from{int_data},
+                    orderBy{},
+                    preSortUnique{},
+                    where{[](int value) { return value != 3; }},
+                    optimize{report}
+                );
+
+    EXPECT_EQ((std::vector<int>{5,8,9}), sorted);
+    ASSERT_EQ(2, report.rewrites_.size());
+    EXPECT_EQ("moved where (operation 3) before order_by (operation 1)", report.rewrites_[0]);
+    EXPECT_EQ("moved where (operation 3) before pre_sort_unique (operation 2)", report.rewrites_[1]);
+
+    // a sort by another predicate does not make the data known sorted
+    processLinq(
+        from{int_data},
+        orderBy{[](int lhs, int rhs) { return lhs % 4 < rhs % 4; }},
+        preSortUnique{},
+        where{[](int value) { return value != 3; }},
+        optimize{report}
+    );
+
+    EXPECT_TRUE(report.rewrites_.empty());
+}
+
+TEST_F(LinqTest, optimizeKeepsIndexedWhereSeparate)
+{
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    optimizerReport report;
+    std::vector<std::string> result;
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ > rhs.age_; }},
+                    where{age_index.between(20, 30)},
+                    where{[](const person &p) { return p.salary_ > 25000; }},
+                    optimize{report}
+                );
+
+    EXPECT_EQ((std::vector<std::string>{"Bolton", "Targaryen", "Tyrell", "Worm"}), result);
+
+    // the index lookup is moved but not merged with the where after it
+    ASSERT_EQ(2, report.rewrites_.size());
+    EXPECT_EQ("moved where (operation 3) before order_by (operation 2)", report.rewrites_[0]);
+    EXPECT_EQ("moved where (operation 4) before order_by (operation 2)", report.rewrites_[1]);
+}
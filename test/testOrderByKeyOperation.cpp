@@ -0,0 +1,289 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <cctype>
+#include <list>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    // deterministic pseudo random values for the larger data sets
+    std::vector<int64_t> generateValues(size_t count)
+    {
+        std::vector<int64_t> values;
+        uint64_t state = 12345;
+        for(size_t i = 0; i < count; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values.push_back(static_cast<int64_t>(state >> 40) - (int64_t{1} << 23));
+        }
+
+        return values;
+    }
+}
+
+TEST_F(LinqTest, orderByKeyUnsignedKey)
+{
+    auto result = processLinq(
+                        from{test_data_},
+                        orderByKey{[](const person &p) { return p.age_; }}
+                    );
+
+    auto expected = test_data_;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; });
+
+    // confirm correct size and order
+    ASSERT_EQ(20, result.size());
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ("Pounce", result.front().last_name_);
+    EXPECT_EQ("Frey", result.back().last_name_);
+}
+
+TEST_F(LinqTest, orderByKeySignedKeyIsStable)
+{
+    auto values = generateValues(5000);
+
+    std::vector<std::pair<int, size_t>> data;
+    for(size_t i = 0; i < values.size(); ++i)
+        data.emplace_back(static_cast<int>(values[i] % 1000), i);
+
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](const std::pair<int, size_t> &value) { return value.first; }}
+                    );
+
+    auto expected = data;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    // equal keys keep their original order
+    EXPECT_EQ(expected, result);
+    EXPECT_LT(result.front().first, 0);
+}
+
+TEST_F(LinqTest, orderByKeyFloatingPointKey)
+{
+    std::vector<double> data{3.5, -0.25, 0.0, -1000.75, 1e300, -1e-300, 42.0, -42.0, 7.0};
+    for(auto value : generateValues(1000))
+        data.push_back(static_cast<double>(value) / 64.0);
+
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](double value) { return value; }}
+                    );
+
+    auto expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, orderByKeySignedZeroIsEqualKey)
+{
+    std::vector<std::pair<double, char>> data{{0.0, 'a'}, {-0.0, 'b'}, {-1.0, 'c'}, {0.0, 'd'}, {-0.0, 'e'}};
+
+    auto result = processLinq(
+                        extract{[](const std::pair<double, char> &p) { return p.second; }},
+                        from{data},
+                        orderByKey{[](const std::pair<double, char> &p) { return p.first; }}
+                    );
+
+    // -0.0 and 0.0 are the same key so keep their order, as with asSet
+    EXPECT_EQ((std::vector<char>{'c', 'a', 'b', 'd', 'e'}), result);
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST_F(LinqTest, orderByKeyIntegerWiderThan64Bits)
+{
+    std::vector<int> data{1, 2, 3};
+
+    // the keys differ only above the low 64 bits
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](int value) { return static_cast<__int128>(3 - value) << 64; }}
+                    );
+
+    EXPECT_EQ((std::vector<int>{3, 2, 1}), result);
+}
+#endif
+
+TEST_F(LinqTest, orderByKeyWideKeyAndWhere)
+{
+    auto values = generateValues(2000);
+
+    auto result = processLinq(
+                        from{values},
+                        where{[](int64_t value) { return value % 3 != 0; }},
+                        orderByKey{[](int64_t value) { return value * 1000003; }},
+                        top{10}
+                    );
+
+    std::vector<int64_t> expected;
+    std::copy_if(values.begin(), values.end(), std::back_inserter(expected),
+                 [](int64_t value) { return value % 3 != 0; });
+    std::sort(expected.begin(), expected.end());
+    expected.resize(10);
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, orderByKeyComparisonSortFallback)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.last_name_; }},
+                        from{test_data_},
+                        orderByKey{[](const person &p) { return p.last_name_; }},
+                        top{3}
+                    );
+
+    // string keys use the comparison sort
+    EXPECT_EQ((std::vector<std::string>{"Baelish", "Baratheon", "Bolton"}), result);
+}
+
+TEST_F(LinqTest, orderByKeyListAndAsSet)
+{
+    std::list<int> list_data{5, -3, 9, 0, -7};
+
+    auto list_result = processLinq(
+                        from{list_data},
+                        orderByKey{[](int value) { return value < 0 ? -value : value; }}
+                    );
+
+    EXPECT_EQ((std::list<int>{0, -3, 5, -7, 9}), list_result);
+
+    auto set_result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        orderByKey{[](const std::string &name) { return name.size(); }},
+                        asSet{}
+                    );
+
+    // the set orders, and so keeps one name for each, length
+    EXPECT_EQ(6, set_result.size());
+    EXPECT_EQ(3, set_result.begin()->size());
+    EXPECT_EQ(8, set_result.rbegin()->size());
+}
+
+TEST_F(LinqTest, orderByKeyComputesEachKeyOnce)
+{
+    size_t key_count = 0;
+
+    auto result = processLinq(
+                        from{test_data_},
+                        orderByKey{[&key_count](const person &p) {
+                                       ++key_count;
+                                       std::string name = p.last_name_ + p.first_name_;
+                                       std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                                       return name;
+                                   }}
+                    );
+
+    // one key for each element, none recomputed by the sort
+    EXPECT_EQ(20, key_count);
+    EXPECT_EQ("Baelish", result.front().last_name_);
+    EXPECT_EQ("Worm", result.back().last_name_);
+}
+
+TEST_F(LinqTest, orderByKeyWithKeyCompare)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        orderByKey{[](const person &p) { return std::make_tuple(p.age_ / 10, p.salary_); },
+                                   std::greater<>{}},
+                        top{4}
+                    );
+
+    // descending by decade of age then salary
+    EXPECT_EQ((std::vector<std::string>{"Walder", "Davos", "Ned", "Petyr"}), result);
+}
+
+TEST_F(LinqTest, orderByKeyDescendingRadixIsStable)
+{
+    std::deque<std::pair<double, int>> data{{1.5, 0}, {-2.0, 1}, {1.5, 2}, {8.0, 3}, {-2.0, 4}, {0.0, 5}};
+
+    auto result = processLinq(
+                        extract{[](const std::pair<double, int> &value) { return value.second; }},
+                        from{data},
+                        orderByKey{[](const std::pair<double, int> &value) { return value.first; }, std::greater<>{}}
+                    );
+
+    EXPECT_EQ((std::vector<int>{3, 0, 2, 5, 1, 4}), result);
+}
+
+TEST_F(LinqTest, orderByKeyListKeysComputedOnce)
+{
+    std::list<std::string> list_data{"delta", "Alpha", "charlie", "Bravo"};
+    size_t key_count = 0;
+
+    auto result = processLinq(
+                        from{list_data},
+                        orderByKey{[&key_count](const std::string &value) {
+                                       ++key_count;
+                                       return static_cast<char>(::tolower(value.front()));
+                                   }}
+                    );
+
+    EXPECT_EQ(4, key_count);
+    EXPECT_EQ((std::list<std::string>{"Alpha", "Bravo", "charlie", "delta"}), result);
+}
+
+TEST_F(LinqTest, orderByKeySkipTakeMatchesFullSort)
+{
+    auto values = generateValues(5000);
+    for(auto &value : values)
+        value %= 100;
+
+    std::vector<std::pair<int64_t, size_t>> data;
+    for(size_t i = 0; i < values.size(); ++i)
+        data.emplace_back(values[i], i);
+
+    auto key = [](const std::pair<int64_t, size_t> &value) { return value.first; };
+    auto full = processLinq(from{data}, orderByKey{key});
+    auto descending = processLinq(from{data}, orderByKey{key, std::greater<>{}}.thenBy([](const auto &value) { return value.second % 7; }));
+
+    for(size_t first : {size_t{0}, size_t{1}, size_t{2499}, size_t{4990}, size_t{5000}, size_t{6000}})
+    {
+        for(size_t count : {size_t{0}, size_t{1}, size_t{60}, size_t{6000}})
+        {
+            auto expected_first = std::min(first, full.size());
+            auto expected_last = expected_first + std::min(count, full.size() - expected_first);
+
+            // the window of the stable ordering, equal keys in source order
+            EXPECT_EQ(decltype(full)(full.begin() + expected_first, full.begin() + expected_last),
+                      processLinq(from{data}, orderByKey{key}, skip{first}, take{count}));
+
+            EXPECT_EQ(decltype(descending)(descending.begin() + expected_first, descending.begin() + expected_last),
+                      processLinq(from{data},
+                                  orderByKey{key, std::greater<>{}}.thenBy([](const auto &value) { return value.second % 7; }),
+                                  skip{first},
+                                  take{count}));
+        }
+    }
+}
+
+TEST_F(LinqTest, orderByKeyTakeComputesEachKeyOnce)
+{
+    size_t key_count = 0;
+
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        orderByKey{[&key_count](const person &p) { ++key_count; return p.salary_; }},
+                        take{3}
+                    );
+
+    EXPECT_EQ(20, key_count);
+    EXPECT_EQ((std::vector<std::string>{"Ser", "Meera", "Podrick"}), result);
+    EXPECT_EQ(processLinq(extract{[](const person &p) { return p.first_name_; }},
+                          from{test_data_},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; }},
+                          take{3}),
+              result);
+}
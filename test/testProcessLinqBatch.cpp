@@ -0,0 +1,176 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <numeric>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, batchMatchesSeparateQueries)
+{
+    auto [young, names, oldest] = processLinqBatch(
+                    test_data_,
+                    query{where{[](const person &p) { return p.age_ < 30; }},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}},
+                    query{extract{[](const person &p) { return p.first_name_; }},
+                          where{[](const person &p) { return p.salary_ > 50000; }}},
+                    query{extract{[](const person &p) { return p.last_name_; }},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ > rhs.age_; }},
+                          top{3}}
+                );
+
+    EXPECT_EQ(processLinq(from{test_data_},
+                          where{[](const person &p) { return p.age_ < 30; }},
+                          orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}),
+              young);
+
+    EXPECT_EQ((std::vector<std::string>{"Ned", "Daenerys", "Tyrion"}), names);
+    EXPECT_EQ((std::vector<std::string>{"Frey", "Seaworth", "Stark"}), oldest);
+}
+
+TEST_F(LinqTest, batchAggregates)
+{
+    auto [young, none] = processLinqBatch(
+                    test_data_,
+                    query{where{[](const person &p) { return p.age_ < 30; }},
+                          sumOf{[](const person &p) { return p.salary_; }},
+                          minOf{[](const person &p) { return p.age_; }},
+                          maxOf{[](const person &p) { return p.age_; }}},
+                    query{where{[](const person &p) { return p.age_ > 100; }},
+                          minOf{[](const person &p) { return p.salary_; }}}
+                );
+
+    EXPECT_DOUBLE_EQ(210284.42, std::get<0>(young));
+    EXPECT_EQ(5, *std::get<1>(young));
+    EXPECT_EQ(27, *std::get<2>(young));
+
+    // no elements passed so no minimum
+    EXPECT_FALSE(std::get<0>(none).has_value());
+}
+
+TEST_F(LinqTest, batchLaterWhereAfterProcessing)
+{
+    // only the where before the top is tested during the scan
+    auto [result] = processLinqBatch(
+                    test_data_,
+                    query{where{[](const person &p) { return p.salary_ > 20000; }},
+                          top{5},
+                          where{[](const person &p) { return p.age_ > 35; }}}
+                );
+
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ("Ned", result[0].first_name_);
+    EXPECT_EQ("Tyrion", result[1].first_name_);
+    EXPECT_EQ("Sandor", result[2].first_name_);
+}
+
+namespace
+{
+    struct counted
+    {
+        static inline size_t copies_ = 0;
+
+        int value_;
+
+        counted(int value)
+            :value_(value)
+        { }
+
+        counted(const counted &other)
+            :value_(other.value_)
+        {
+            ++copies_;
+        }
+
+        counted(counted &&) = default;
+        counted &operator=(const counted &) = default;
+        counted &operator=(counted &&) = default;
+
+        bool operator<(const counted &other) const { return value_ < other.value_; }
+    };
+}
+
+TEST_F(LinqTest, batchCopiesOnlyKeptElements)
+{
+    std::vector<counted> source;
+    for(int value = 0; value < 100; ++value)
+        source.emplace_back(value);
+
+    counted::copies_ = 0;
+
+    auto [values, large] = processLinqBatch(
+                    source,
+                    query{extract{[](const counted &c) { return c.value_; }},
+                          where{[](const counted &c) { return c.value_ % 10 == 0; }}},
+                    query{where{[](const counted &c) { return c.value_ >= 95; }}}
+                );
+
+    // the source is not copied, only the kept elements are, an extract keeps
+    // only the extracted values
+    EXPECT_EQ(5, counted::copies_);
+
+    EXPECT_EQ((std::vector<int>{0,10,20,30,40,50,60,70,80,90}), values);
+    ASSERT_EQ(5, large.size());
+    EXPECT_EQ(95, large.front().value_);
+}
+
+TEST_F(LinqTest, batchCancelledDuringScan)
+{
+    std::vector<int> source(100000);
+    std::iota(source.begin(), source.end(), 0);
+
+    cancellationToken token;
+    size_t tested = 0;
+
+    // cancel part way through the first chunk, the scan stops at its end
+    // rather than after the whole source
+    EXPECT_THROW(processLinqBatch(
+                    source,
+                    query{where{[&](int value) {
+                              if(++tested == 1000)
+                                  token.cancel();
+                              return value % 2 == 0;
+                          }},
+                          cancelWhen{token},
+                          orderBy{}},
+                    query{where{[](int value) { return value < 10; }}}
+                 ),
+                 queryCancelled);
+
+    EXPECT_EQ(cancelWhen::chunk_size_, tested);
+}
+
+TEST_F(LinqTest, batchBudgetCheckedDuringScan)
+{
+    std::vector<int> source(100000);
+    std::iota(source.begin(), source.end(), 0);
+
+    // the kept elements do not fit, the scan stops before going over
+    memoryUsage usage;
+    try
+    {
+        processLinqBatch(source,
+                         query{where{[](int value) { return value % 2 == 0; }},
+                               memoryBudget{1000 * sizeof(int), usage},
+                               orderBy{}});
+        FAIL() << "expected the budget to be exceeded";
+    }
+    catch(const memoryBudgetExceeded &exceeded)
+    {
+        EXPECT_EQ("where", exceeded.operation_);
+    }
+
+    EXPECT_LE(usage.peak_bytes_, 1000 * sizeof(int));
+
+    // kept elements within the budget
+    auto [small] = processLinqBatch(source,
+                                    query{where{[](int value) { return value < 100; }},
+                                          memoryBudget{1000 * sizeof(int)},
+                                          orderBy{[](int lhs, int rhs) { return lhs > rhs; }}});
+
+    ASSERT_EQ(100, small.size());
+    EXPECT_EQ(99, small.front());
+}
@@ -0,0 +1,110 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, processIntoReusesVectorCapacity)
+{
+    std::vector<person> result;
+    result.reserve(64);
+    const auto *storage = result.data();
+
+    processLinqInto(result,
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ < 30; }}
+                );
+
+    // confirm correct size
+    EXPECT_EQ(9, result.size());
+
+    // confirm the existing storage was used
+    EXPECT_EQ(storage, result.data());
+    EXPECT_EQ(64, result.capacity());
+
+    // a second call clears the previous results
+    processLinqInto(result,
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ > 50; }}
+                );
+
+    EXPECT_EQ(5, result.size());
+    EXPECT_EQ(storage, result.data());
+    EXPECT_TRUE(existsInResult(result, [](const person &p) { return p.last_name_ == "Frey"; }));
+    EXPECT_FALSE(existsInResult(result, [](const person &p) { return p.last_name_ == "Snow"; }));
+}
+
+TEST_F(LinqTest, processIntoWithExtractOrderingAndTop)
+{
+    std::vector<std::string> result{"stale", "data"};
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    top{3}
+                );
+
+    // confirm correct size and the stale data removed
+    EXPECT_EQ(3, result.size());
+
+    // confirm correct order
+    EXPECT_EQ("Ser", result[0]);
+    EXPECT_EQ("Meera", result[1]);
+    EXPECT_EQ("Podrick", result[2]);
+}
+
+TEST_F(LinqTest, processIntoDeque)
+{
+    std::deque<std::string> result{"stale"};
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_},
+                    bottom{2}
+                );
+
+    EXPECT_EQ(2, result.size());
+    EXPECT_EQ("Pounce", result.front());
+    EXPECT_EQ("Frey", result.back());
+}
+
+TEST_F(LinqTest, processIntoUnorderedMapKeepsBuckets)
+{
+    std::unordered_map<std::string, double> result;
+    result.reserve(128);
+    auto bucket_count = result.bucket_count();
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return std::make_pair(p.last_name_, p.salary_); }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.salary_ < 30000; }}
+                );
+
+    // confirm correct size
+    EXPECT_EQ(8, result.size());
+    EXPECT_EQ(bucket_count, result.bucket_count());
+
+    // check correct data
+    EXPECT_TRUE(result.find("Bolton")!=result.end());
+    EXPECT_DOUBLE_EQ(result.find("Bolton")->second, 27044);
+    EXPECT_TRUE(result.find("Snow")==result.end());
+}
+
+TEST_F(LinqTest, processIntoSet)
+{
+    std::set<std::string> result{"stale"};
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_}
+                );
+
+    EXPECT_EQ(20, result.size());
+    EXPECT_EQ("Baelish", *(result.begin()));
+    EXPECT_EQ("Worm", *(result.rbegin()));
+    EXPECT_TRUE(result.find("stale")==result.end());
+}
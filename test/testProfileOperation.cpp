@@ -0,0 +1,130 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, profileRecordsEachStage)
+{
+    pipelineStats stats;
+
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        where{[](const person &p) { return p.age_ < 30; }},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                        top{3},
+                        profile{stats}
+                    );
+
+    ASSERT_EQ(3, result.size());
+
+    // stages in processing order, the extract last
+    ASSERT_EQ(4, stats.stages_.size());
+    EXPECT_EQ(where_name(), stats.stages_[0].operation_);
+    EXPECT_EQ(order_by_name(), stats.stages_[1].operation_);
+    EXPECT_EQ(top_name(), stats.stages_[2].operation_);
+    EXPECT_EQ(extract_name(), stats.stages_[3].operation_);
+
+    EXPECT_EQ(20, stats.stages_[0].elements_in_);
+    EXPECT_EQ(9, stats.stages_[0].elements_out_);
+    EXPECT_EQ(9, stats.stages_[1].elements_in_);
+    EXPECT_EQ(9, stats.stages_[1].elements_out_);
+    EXPECT_EQ(3, stats.stages_[2].elements_out_);
+    EXPECT_EQ(3, stats.stages_[3].elements_in_);
+    EXPECT_EQ(3, stats.stages_[3].elements_out_);
+
+    // storage of the results of each stage
+    EXPECT_GE(stats.stages_[0].bytes_allocated_, 9 * sizeof(person));
+    EXPECT_GE(stats.stages_[0].peak_bytes_, 29 * sizeof(person));
+    EXPECT_GE(stats.stages_[3].bytes_allocated_, 3 * sizeof(std::string));
+    EXPECT_EQ(stats.stages_[0].peak_bytes_, stats.peakBytes());
+
+    auto total = stats.stages_[0].duration_ + stats.stages_[1].duration_ +
+                 stats.stages_[2].duration_ + stats.stages_[3].duration_;
+    EXPECT_EQ(total, stats.duration());
+}
+
+TEST_F(LinqTest, profileCallbackAndRepeatedProcessing)
+{
+    pipelineStats stats;
+    std::vector<std::string> names;
+
+    auto callback = [&names](const stageStats &stage) { names.emplace_back(stage.operation_); };
+
+    for(int run = 0; run < 2; ++run)
+    {
+        auto result = processLinq(
+                            from{test_data_},
+                            where{[](const person &p) { return p.salary_ > 40000; }},
+                            stableUnique{},
+                            profile{stats, callback}
+                        );
+
+        EXPECT_EQ(7, result.size());
+    }
+
+    // stats hold the last processing, the callback is called for every stage
+    EXPECT_EQ(2, stats.stages_.size());
+    EXPECT_EQ((std::vector<std::string>{"where", "stable_unique", "where", "stable_unique"}), names);
+}
+
+namespace
+{
+    // counts the stages it is called for, recording its count at each one
+    struct stageCounter
+    {
+        std::vector<int> *counts_;
+        int count_ = 0;
+
+        void operator()(const stageStats &)
+        {
+            counts_->push_back(++count_);
+        }
+    };
+}
+
+TEST_F(LinqTest, profileStatefulCallbackKeepsState)
+{
+    pipelineStats stats;
+    std::vector<int> counts;
+
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        where{[](const person &p) { return p.age_ < 30; }},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                        profile{stats, stageCounter{&counts}}
+                    );
+
+    EXPECT_EQ(9, result.size());
+
+    // the same callback is called for each stage
+    EXPECT_EQ(stats.stages_.size(), counts.size());
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), counts);
+}
+
+TEST_F(LinqTest, profileIndexedWhereAndProcessLinqInto)
+{
+    pipelineStats stats;
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    std::vector<unsigned int> ages;
+    processLinqInto(ages,
+                    extract{[](const person &p) { return p.age_; }},
+                    from{age_index.source()},
+                    where{age_index.between(20, 29)},
+                    profile{stats}
+                );
+
+    EXPECT_EQ((std::vector<unsigned int>{26, 27, 24, 23, 23}), ages);
+
+    ASSERT_EQ(2, stats.stages_.size());
+    EXPECT_EQ(where_name(), stats.stages_[0].operation_);
+    EXPECT_EQ(5, stats.stages_[0].elements_out_);
+    EXPECT_EQ(extract_name(), stats.stages_[1].operation_);
+    EXPECT_EQ(5, stats.stages_[1].elements_out_);
+}
@@ -0,0 +1,196 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, sortedIndexEqualityLookup)
+{
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    auto result = processLinq(
+                        from{age_index.source()},
+                        where{age_index.equalTo(23)}
+                    );
+
+    // confirm the same results, in source order, as a scan
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ("Tarly", result[0].last_name_);
+    EXPECT_EQ("Worm", result[1].last_name_);
+
+    auto missing = processLinq(
+                        from{age_index.source()},
+                        where{age_index.equalTo(99)}
+                    );
+
+    EXPECT_TRUE(missing.empty());
+}
+
+TEST_F(LinqTest, sortedIndexRangeLookups)
+{
+    sortedIndex salary_index{test_data_, [](const person &p) { return p.salary_; }};
+
+    auto scan = [this](auto predicate) {
+        std::vector<person> expected;
+        std::copy_if(test_data_.begin(), test_data_.end(), std::back_inserter(expected), predicate);
+        return expected;
+    };
+
+    EXPECT_EQ(scan([](const person &p) { return p.salary_ >= 20000 && p.salary_ <= 35000; }),
+              processLinq(from{salary_index.source()}, where{salary_index.between(20000, 35000)}));
+
+    EXPECT_EQ(scan([](const person &p) { return p.salary_ < 27500.90; }),
+              processLinq(from{salary_index.source()}, where{salary_index.lessThan(27500.90)}));
+
+    EXPECT_EQ(scan([](const person &p) { return p.salary_ <= 27500.90; }),
+              processLinq(from{salary_index.source()}, where{salary_index.atMost(27500.90)}));
+
+    EXPECT_EQ(scan([](const person &p) { return p.salary_ > 50000; }),
+              processLinq(from{salary_index.source()}, where{salary_index.greaterThan(50000)}));
+
+    EXPECT_EQ(scan([](const person &p) { return p.salary_ >= 50000; }),
+              processLinq(from{salary_index.source()}, where{salary_index.atLeast(50000)}));
+
+    EXPECT_TRUE(processLinq(from{salary_index.source()}, where{salary_index.between(35000, 20000)}).empty());
+}
+
+TEST_F(LinqTest, hashIndexWithFollowingOperations)
+{
+    std::vector<person> data = test_data_;
+    data.push_back({"Arya", "Stark", 11, 100.00});
+    data.push_back({"Sansa", "Stark", 13, 200.00});
+
+    hashIndex name_index{data, [](const person &p) { return p.last_name_; }};
+
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{name_index.source()},
+                        where{name_index.equalTo("Stark")},
+                        orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}
+                    );
+
+    EXPECT_EQ((std::vector<std::string>{"Arya", "Sansa", "Ned"}), result);
+    EXPECT_TRUE(processLinq(from{name_index.source()}, where{name_index.equalTo("Lannister")}).size() == 1);
+    EXPECT_TRUE(processLinq(from{name_index.source()}, where{name_index.equalTo("Tully")}).empty());
+}
+
+TEST_F(LinqTest, indexUpdatedForAppendedElements)
+{
+    std::vector<person> data = test_data_;
+
+    sortedIndex age_index{data, [](const person &p) { return p.age_; }};
+    hashIndex age_hash{data, [](const person &p) { return p.age_; }};
+
+    data.push_back({"Arya", "Stark", 23, 100.00});
+    data.push_back({"Hodor", "Hodor", 40, 500.00});
+
+    // a stale index is not used, the where falls back to a scan
+    EXPECT_FALSE(age_index.current(data.size()));
+    EXPECT_EQ(3, processLinq(from{age_index.source()}, where{age_index.equalTo(23)}).size());
+
+    age_index.update();
+    age_hash.update();
+
+    EXPECT_TRUE(age_index.current(data.size()));
+    EXPECT_EQ(22, age_index.size());
+
+    auto result = processLinq(from{age_index.source()}, where{age_index.equalTo(23)});
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ("Arya", result[2].first_name_);
+
+    EXPECT_EQ(result, processLinq(from{age_hash.source()}, where{age_hash.equalTo(23)}));
+    EXPECT_EQ(1, processLinq(from{age_index.source()}, where{age_index.between(39, 41)}).size());
+
+    // a smaller source is indexed again in full
+    data.resize(5);
+    age_index.update();
+    EXPECT_EQ(5, age_index.size());
+    EXPECT_EQ(1, processLinq(from{age_index.source()}, where{age_index.atMost(26)}).size());
+}
+
+TEST_F(LinqTest, indexLookupAfterOtherOperations)
+{
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    // not the first operation, so the lookup tests each element as a where
+    // predicate
+    auto result = processLinq(
+                        from{test_data_},
+                        where{[](const person &p) { return p.salary_ < 40000; }},
+                        where{age_index.lessThan(30)}
+                    );
+
+    auto expected = processLinq(
+                        from{test_data_},
+                        where{[](const person &p) { return p.salary_ < 40000 && p.age_ < 30; }}
+                    );
+
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ(8, result.size());
+}
+
+TEST_F(LinqTest, indexAnswersOnlyForItsSource)
+{
+    sortedIndex age_index{test_data_, [](const person &p) { return p.age_; }};
+
+    // another source of the same size
+    std::vector<person> other = test_data_;
+    for(auto &p : other)
+        p.age_ += 100;
+
+    EXPECT_TRUE(age_index.equalTo(23).current(test_data_));
+    EXPECT_FALSE(age_index.equalTo(23).current(other));
+
+    // the lookup tests the elements of the other source
+    EXPECT_TRUE(processLinq(from{other}, where{age_index.equalTo(23)}).empty());
+    EXPECT_EQ(2, processLinq(from{other}, where{age_index.equalTo(123)}).size());
+
+    // a copy of the source given to from is scanned, with the same results
+    EXPECT_EQ(processLinq(from{age_index.source()}, where{age_index.between(20, 30)}),
+              processLinq(from{test_data_}, where{age_index.between(20, 30)}));
+}
+
+namespace
+{
+    // counts the copies made of it
+    struct countedCopy
+    {
+        int key_;
+
+        countedCopy(int key) :key_(key) { }
+        countedCopy(const countedCopy &other) :key_(other.key_) { ++copies_; }
+        countedCopy &operator=(const countedCopy &other) { key_ = other.key_; ++copies_; return *this; }
+        countedCopy(countedCopy&&) = default;
+        countedCopy &operator=(countedCopy&&) = default;
+
+        static inline size_t copies_ = 0;
+    };
+}
+
+TEST_F(LinqTest, indexLookupCopiesOnlyMatches)
+{
+    std::vector<countedCopy> data;
+    for(int key = 0; key < 1000; ++key)
+        data.emplace_back(key);
+
+    sortedIndex key_index{data, [](const countedCopy &value) { return value.key_; }};
+    hashIndex key_hash{data, [](const countedCopy &value) { return value.key_ % 100; }};
+
+    countedCopy::copies_ = 0;
+    auto result = processLinq(from{key_index.source()}, where{key_index.between(10, 14)});
+
+    ASSERT_EQ(5, result.size());
+    EXPECT_EQ(10, result.front().key_);
+    EXPECT_EQ(5, countedCopy::copies_);
+
+    countedCopy::copies_ = 0;
+    EXPECT_EQ(10, processLinq(from{key_hash.source()}, where{key_hash.equalTo(7)}).size());
+    EXPECT_EQ(10, countedCopy::copies_);
+
+    // the source is unchanged
+    EXPECT_EQ(1000, data.size());
+    EXPECT_EQ(10, data[10].key_);
+}
@@ -0,0 +1,165 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <random>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, skipTakePageAfterOrderBy)
+{
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.salary_ < rhs.salary_; }},
+                    skip{5},
+                    take{4}
+                );
+
+    // the 6th to 9th lowest salaries in order
+    EXPECT_EQ((std::vector<std::string>{"Theon", "Ramsay", "Grey", "Joffrey"}), result);
+}
+
+TEST_F(LinqTest, skipTakeSelectionMatchesFullSort)
+{
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> distribution{0, 500};
+
+    std::vector<int> int_data(2000);
+    std::generate(int_data.begin(), int_data.end(), [&]() { return distribution(generator); });
+
+    auto sorted = int_data;
+    std::sort(sorted.begin(), sorted.end());
+
+    for(size_t first : {size_t{0}, size_t{1}, size_t{999}, size_t{1990}, size_t{2000}, size_t{2500}})
+    {
+        for(size_t count : {size_t{0}, size_t{1}, size_t{50}, size_t{3000}})
+        {
+            auto result = processLinq(from{int_data}, orderBy{}, skip{first}, take{count});
+
+            auto expected_first = sorted.begin() + std::min(first, sorted.size());
+            auto expected_last = expected_first + std::min<size_t>(count, sorted.end() - expected_first);
+            EXPECT_EQ((std::vector<int>(expected_first, expected_last)), result);
+        }
+    }
+}
+
+TEST_F(LinqTest, takeBeforeSkipAfterOrderBy)
+{
+    std::vector<int> int_data{9,3,7,1,8,2,6,4,5};
+
+    // keep the first 6 then skip 2 of those
+    auto result = processLinq(
+                    from{int_data},
+                    orderBy{[](int lhs, int rhs) { return lhs > rhs; }},
+                    take{6},
+                    skip{2}
+                );
+
+    EXPECT_EQ((std::vector<int>{7,6,5,4}), result);
+
+    // skip more than taken
+    result = processLinq(from{int_data}, orderBy{}, take{3}, skip{5});
+    EXPECT_TRUE(result.empty());
+}
+
+TEST_F(LinqTest, skipTakeWithoutOrdering)
+{
+    auto result = processLinq(
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ > 30; }},
+                    skip{2},
+                    take{3}
+                );
+
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ("Tyrion", result[0].first_name_);
+    EXPECT_EQ("Sandor", result[1].first_name_);
+    EXPECT_EQ("Petyr", result[2].first_name_);
+
+    auto names = processLinq(
+                    extract{[](const person &p) { return p.last_name_; }},
+                    from{test_data_},
+                    skip{18},
+                    asDeque{}
+                );
+
+    EXPECT_EQ((std::deque<std::string>{"Pounce", "Frey"}), names);
+}
+
+TEST_F(LinqTest, skipTakeOrderingNotMovedAcrossWhere)
+{
+    // a where between the orderBy and the take needs the full ordering
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }},
+                    where{[](const person &p) { return p.salary_ > 40000; }},
+                    take{3}
+                );
+
+    EXPECT_EQ((std::vector<std::string>{"Daenerys", "John", "Khal"}), result);
+}
+
+namespace
+{
+    // counts the moves made of it
+    struct countedMove
+    {
+        int value_;
+
+        countedMove(int value) :value_(value) { }
+        countedMove(const countedMove&) = default;
+        countedMove &operator=(const countedMove&) = default;
+        countedMove(countedMove &&other) noexcept :value_(other.value_) { ++moves_; }
+        countedMove &operator=(countedMove &&other) noexcept { value_ = other.value_; ++moves_; return *this; }
+
+        static inline size_t moves_ = 0;
+    };
+}
+
+TEST_F(LinqTest, skipMovesOnlyTheTakenElements)
+{
+    std::vector<countedMove> data;
+    data.reserve(1000);
+    for(int value = 0; value < 1000; ++value)
+        data.emplace_back(value);
+
+    // the page of 5 after the first 900, the 95 elements after the page are
+    // not moved forward
+    countedMove::moves_ = 0;
+    auto result = processLinq(from{std::move(data)}, skip{900}, take{5});
+
+    ASSERT_EQ(5, result.size());
+    EXPECT_EQ(900, result.front().value_);
+    EXPECT_EQ(904, result.back().value_);
+    EXPECT_EQ(5, countedMove::moves_);
+
+    // a skip alone keeps all the elements after it
+    std::vector<int> int_data{1,2,3,4,5,6};
+    EXPECT_EQ((std::vector<int>{5,6}), processLinq(from{int_data}, skip{4}));
+    EXPECT_EQ((std::vector<int>{3,4}), processLinq(from{int_data}, take{4}, skip{2}));
+    EXPECT_TRUE(processLinq(from{int_data}, skip{7}, take{2}).empty());
+}
+
+TEST_F(LinqTest, skipKeepsAllElementsForStagesBeforeTake)
+{
+    std::vector<int> int_data{1,2,3,4,5,6,7,8,9,10};
+
+    // the where between the skip and the take sees every element after the skip
+    auto result = processLinq(
+                    from{int_data},
+                    skip{2},
+                    where{[](int value) { return value % 2 == 0; }},
+                    take{3}
+                );
+
+    EXPECT_EQ((std::vector<int>{4,6,8}), result);
+
+    // the orderBy between the skip and the take orders every element after the skip
+    std::vector<int> descending{9,8,7,6,5,4,3,2,1,0};
+    EXPECT_EQ((std::vector<int>{0,1,2}), processLinq(from{descending}, skip{2}, orderBy{}, take{3}));
+}
@@ -0,0 +1,125 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, sortedInputBuildsSetWithoutSearching)
+{
+    std::vector<int> int_data(10000);
+    std::iota(int_data.begin(), int_data.end(), 0);
+
+    size_t comparisons = 0;
+    auto result = processLinq(
+                    extract{[](int value) { return value; }},
+                    from{int_data},
+                    orderBy{[&comparisons](int lhs, int rhs) { ++comparisons; return lhs < rhs; }},
+                    asSet{}
+                );
+
+    ASSERT_EQ(int_data.size(), result.size());
+    EXPECT_TRUE(std::equal(int_data.begin(), int_data.end(), result.begin()));
+
+    // the order check and a few comparisons with the last element for each
+    // insert, a search of the tree would take about 14 for each insert
+    EXPECT_GT(5 * int_data.size(), comparisons);
+}
+
+TEST_F(LinqTest, unsortedInputBuildsSameMap)
+{
+    std::mt19937 generator{7};
+    std::uniform_int_distribution<int> distribution{0, 300};
+
+    std::vector<std::pair<int, int>> pairs(2000);
+    for(size_t i = 0; i < pairs.size(); ++i)
+        pairs[i] = {distribution(generator), static_cast<int>(i)};
+
+    auto result = processLinq(
+                    extract{[](const std::pair<int, int> &p) { return p; }},
+                    from{pairs},
+                    asMap{}
+                );
+
+    // the first of the equal keys is kept, as when inserted one at a time
+    std::map<int, int> expected;
+    for(const auto &p : pairs)
+        expected.insert(p);
+
+    EXPECT_EQ(expected, result);
+
+    // the same without an extract
+    EXPECT_EQ(expected, processLinq(from{pairs}, asMap{}));
+}
+
+TEST_F(LinqTest, sortedBulkLoadWithDescendingOrder)
+{
+    auto result = processLinq(
+                    extract{[](const person &p) { return std::make_pair(p.last_name_, p.age_); }},
+                    from{test_data_},
+                    orderBy{[](const std::string &lhs, const std::string &rhs) { return lhs > rhs; }},
+                    asMap{}
+                );
+
+    ASSERT_EQ(20, result.size());
+    EXPECT_EQ("Worm", result.begin()->first);
+    EXPECT_EQ("Baelish", result.rbegin()->first);
+
+    // an orderBy with no predicate uses operator<
+    std::vector<int> int_data{5,3,9,3,1};
+    auto ascending = processLinq(extract{[](int value) { return value; }}, from{int_data}, orderBy{}, asSet{});
+    EXPECT_EQ((std::set<int>{1,3,5,9}), ascending);
+}
+
+TEST_F(LinqTest, sortedBulkLoadIntoExistingSet)
+{
+    std::set<std::string> result{"Aardvark", "Zebra"};
+
+    processLinqInto(result,
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{test_data_},
+                    where{[](const person &p) { return p.age_ < 30; }});
+
+    // results are cleared before they are filled
+    EXPECT_EQ((std::set<std::string>{"Daenerys", "Grey", "Joffrey", "Margaery", "Meera",
+                                      "Podrick", "Ramsay", "Samwell", "Ser"}), result);
+}
+
+TEST_F(LinqTest, sortedBulkLoadKeepsEqualKeysInMultiContainers)
+{
+    std::vector<int> int_data{5,3,9,3,1,5,3};
+
+    // every element is kept, as by inserting one at a time
+    std::multiset<int> values;
+    processLinqInto(values, extract{[](int value) { return value; }}, from{int_data});
+    EXPECT_EQ((std::multiset<int>{1,3,3,3,5,5,9}), values);
+
+    std::multiset<int> unextracted;
+    processLinqInto(unextracted, from{int_data}, orderBy{});
+    EXPECT_EQ(values, unextracted);
+
+    // equal keys keep the order they are given in
+    std::vector<std::pair<std::string, int>> pairs{{"Stark", 1}, {"Lannister", 2}, {"Stark", 3},
+                                                   {"Arryn", 4}, {"Lannister", 5}, {"Stark", 6}};
+
+    std::multimap<std::string, int> families;
+    processLinqInto(families,
+                    extract{[](const std::pair<std::string, int> &p) { return p; }},
+                    from{pairs});
+
+    std::multimap<std::string, int> expected;
+    for(const auto &p : pairs)
+        expected.insert(p);
+
+    EXPECT_EQ(expected, families);
+    EXPECT_EQ((std::vector<std::pair<const std::string, int>>{{"Arryn", 4}, {"Lannister", 2}, {"Lannister", 5},
+                                                              {"Stark", 1}, {"Stark", 3}, {"Stark", 6}}),
+              (std::vector<std::pair<const std::string, int>>(families.begin(), families.end())));
+}
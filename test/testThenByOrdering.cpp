@@ -0,0 +1,165 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <list>
+#include <tuple>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    // deterministic pseudo random values for the larger data sets
+    std::vector<int> generateValues(size_t count, int range)
+    {
+        std::vector<int> values;
+        uint64_t state = 54321;
+        for(size_t i = 0; i < count; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values.push_back(static_cast<int>((state >> 33) % range));
+        }
+
+        return values;
+    }
+}
+
+TEST_F(LinqTest, thenByOrdersEqualLeadingKeys)
+{
+    // name lengths repeat so the last name orders the ties
+    auto result = processLinq(
+                        from{test_data_},
+                        orderByKey{[](const person &p) { return p.first_name_.size(); }}
+                            .thenBy([](const person &p) { return p.last_name_; })
+                    );
+
+    auto expected = test_data_;
+    std::sort(expected.begin(), expected.end(), [](const person &lhs, const person &rhs) {
+                  return std::make_tuple(lhs.first_name_.size(), lhs.last_name_) <
+                         std::make_tuple(rhs.first_name_.size(), rhs.last_name_);
+              });
+
+    ASSERT_EQ(20, result.size());
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ("Pounce", result.front().last_name_);
+    EXPECT_EQ("Tyrell", result.back().last_name_);
+}
+
+TEST_F(LinqTest, thenByDescendingWithDescendingLeadingKey)
+{
+    auto values = generateValues(4000, 50);
+
+    std::vector<std::tuple<int, int, size_t>> data;
+    for(size_t i = 0; i < values.size(); ++i)
+        data.emplace_back(values[i] % 10, values[i] / 10, i);
+
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](const auto &value) { return std::get<0>(value); }, std::greater<>{}}
+                            .thenByDescending([](const auto &value) { return std::get<1>(value); })
+                    );
+
+    auto expected = data;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) {
+                         return std::make_tuple(std::get<0>(rhs), std::get<1>(rhs)) <
+                                std::make_tuple(std::get<0>(lhs), std::get<1>(lhs));
+                     });
+
+    // the ordering stays stable on both keys
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, thenByThreeKeysComparisonLeadingKey)
+{
+    auto values = generateValues(3000, 60);
+
+    std::vector<std::tuple<std::string, int, int>> data;
+    for(size_t i = 0; i < values.size(); ++i)
+        data.emplace_back(std::string(1, static_cast<char>('a' + values[i] % 3)), values[i] % 4, values[i]);
+
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](const auto &value) { return std::get<0>(value); }}
+                            .thenBy([](const auto &value) { return std::get<1>(value); })
+                            .thenBy([](const auto &value) { return std::get<2>(value); }, std::greater<>{})
+                    );
+
+    auto expected = data;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) {
+                         return std::make_tuple(std::get<0>(lhs), std::get<1>(lhs), std::get<2>(rhs)) <
+                                std::make_tuple(std::get<0>(rhs), std::get<1>(rhs), std::get<2>(lhs));
+                     });
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, thenByOnList)
+{
+    std::list<std::pair<int, int>> data;
+    for(auto value : generateValues(500, 100))
+        data.emplace_back(value % 5, value);
+
+    auto result = processLinq(
+                        from{data},
+                        orderByKey{[](const std::pair<int, int> &value) { return value.first; }}
+                            .thenBy([](const std::pair<int, int> &value) { return value.second; })
+                    );
+
+    auto expected = data;
+    expected.sort();
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, thenByOrdersSetResults)
+{
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        orderByKey{[](const std::string &name) { return name.size(); }}
+                            .thenByDescending([](const std::string &name) { return name; }),
+                        asSet{}
+                    );
+
+    // the set keeps every name as the names differ on the second key
+    ASSERT_EQ(20, result.size());
+    EXPECT_EQ("Ser", *result.begin());
+    EXPECT_EQ("Ned", *std::next(result.begin()));
+    EXPECT_EQ("Daenerys", *result.rbegin());
+}
+
+TEST_F(LinqTest, thenByComputesEachKeyOnce)
+{
+    auto values = generateValues(1000, 50);
+
+    size_t radix_calls = 0;
+    size_t comparison_calls = 0;
+
+    auto radix_result = processLinq(
+                        from{values},
+                        orderByKey{[](int value) { return value % 10; }}
+                            .thenBy([&radix_calls](int value) { ++radix_calls; return std::to_string(value); })
+                    );
+
+    auto comparison_result = processLinq(
+                        from{values},
+                        orderByKey{[](int value) { return std::to_string(value % 10); }}
+                            .thenBy([&comparison_calls](int value) { ++comparison_calls; return std::to_string(value); })
+                    );
+
+    // the following key is computed once for each element, not for each
+    // comparison
+    EXPECT_EQ(values.size(), radix_calls);
+    EXPECT_EQ(values.size(), comparison_calls);
+
+    auto expected = values;
+    std::stable_sort(expected.begin(), expected.end(), [](int lhs, int rhs) {
+                         return std::make_pair(lhs % 10, std::to_string(lhs)) < std::make_pair(rhs % 10, std::to_string(rhs));
+                     });
+
+    EXPECT_EQ(expected, radix_result);
+    EXPECT_EQ(expected, comparison_result);
+}
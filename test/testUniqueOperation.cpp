@@ -49,6 +49,20 @@ TEST_F(LinqTest, stableUniqueFilterWithPred)
 
 }
 
+TEST_F(LinqTest, stableUniqueFilterWithPredAndHash)
+{
+    std::vector<int> int_data{11,5,21,15,3,33};
+
+    // unique by the last digit, the hash agrees with the predicate
+    auto result = processLinq(
+                        from{std::move(int_data)},
+                        stableUnique{[](int lhs, int rhs) { return lhs % 10 == rhs % 10; },
+                                     [](int value) { return value % 10; }}
+                );
+
+    EXPECT_EQ((std::vector<int>{11,5,3}), result);
+}
+
 TEST_F(LinqTest, stableUniqueFilterNoPredPlainType)
 {
     std::vector<int> int_data{1,2,3,4,5,6,7,8,9,1,2,3,4,5,6,7,8,9,1,2,3,4,5,6,7,8,9};
@@ -0,0 +1,127 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <thread>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, snapshotQueryMatchesSource)
+{
+    versionedSource source{test_data_};
+
+    auto result = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{source.snapshot()},
+                    where{[](const person &p) { return p.age_ < 20; }},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ < rhs.age_; }}
+                );
+
+    EXPECT_EQ((std::vector<std::string>{"Ser", "Meera", "Podrick", "Joffrey"}), result);
+
+    // an ordering first processes a copy of the snapshot
+    auto ordered = processLinq(
+                    from{source.snapshot()},
+                    orderBy{[](const person &lhs, const person &rhs) { return lhs.age_ > rhs.age_; }},
+                    top{2}
+                );
+
+    ASSERT_EQ(2, ordered.size());
+    EXPECT_EQ("Walder", ordered[0].first_name_);
+    EXPECT_EQ("Davos", ordered[1].first_name_);
+}
+
+TEST_F(LinqTest, snapshotIsolatedFromPublish)
+{
+    versionedSource source{test_data_};
+
+    auto before = source.snapshot();
+    EXPECT_EQ(0, before.version());
+
+    source.update([](std::vector<person> &people) {
+        people.push_back({"Robert", "Baratheon", 45, 90000.00});
+    });
+    source.publish({{"Arya", "Stark", 11, 100.00}});
+
+    // the earlier snapshot still reads its own version
+    EXPECT_EQ(20, before.size());
+    EXPECT_EQ(2, source.version());
+
+    auto after = source.snapshot();
+    EXPECT_EQ(2, after.version());
+
+    auto names = processLinq(
+                    extract{[](const person &p) { return p.first_name_; }},
+                    from{after}
+                );
+
+    EXPECT_EQ((std::vector<std::string>{"Arya"}), names);
+    EXPECT_EQ(20, processLinq(from{before}).size());
+}
+
+TEST_F(LinqTest, versionsReclaimedAfterSnapshotsReleased)
+{
+    std::vector<int> int_data{1,2,3};
+    versionedSource source{int_data};
+
+    {
+        auto held = source.snapshot();
+        auto copy = held;
+
+        source.publish({4,5});
+        source.publish({6});
+
+        // the first version is held, the second is freed
+        EXPECT_EQ(1, source.retained());
+        EXPECT_EQ((std::vector<int>{1,2,3}), processLinq(from{copy}));
+    }
+
+    source.reclaim();
+    EXPECT_EQ(0, source.retained());
+    EXPECT_EQ((std::vector<int>{6}), processLinq(from{source.snapshot()}));
+}
+
+TEST_F(LinqTest, concurrentReadersWithWriter)
+{
+    // every element of version n is n, a reader seeing mixed values would
+    // have read a version while it changed
+    versionedSource source{std::vector<int>(1000, 0), 8};
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> failures{0};
+
+    std::vector<std::thread> readers;
+    for(int reader = 0; reader < 4; ++reader)
+    {
+        readers.emplace_back([&]() {
+            while(!done.load())
+            {
+                auto snapshot = source.snapshot();
+                auto value = static_cast<int>(snapshot.version());
+
+                auto mismatched = processLinq(
+                                    from{snapshot},
+                                    where{[value](int element) { return element != value; }}
+                                );
+
+                if(!mismatched.empty() || snapshot.size() != 1000)
+                    ++failures;
+            }
+        });
+    }
+
+    for(int version = 1; version <= 200; ++version)
+        source.publish(std::vector<int>(1000, version));
+
+    done = true;
+    for(auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(0, failures.load());
+
+    source.reclaim();
+    EXPECT_EQ(0, source.retained());
+}
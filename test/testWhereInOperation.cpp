@@ -0,0 +1,174 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <set>
+#include <unordered_set>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    // deterministic pseudo random values for the larger data sets
+    std::vector<int64_t> generateValues(size_t count, uint64_t state)
+    {
+        std::vector<int64_t> values;
+        for(size_t i = 0; i < count; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values.push_back(static_cast<int64_t>(state >> 20));
+        }
+
+        return values;
+    }
+}
+
+TEST_F(LinqTest, whereInSmallKeySet)
+{
+    std::vector<std::string> names{"Stark", "Snow", "Lannister", "Tully"};
+
+    auto result = processLinq(
+                        extract{[](const person &p) { return p.first_name_; }},
+                        from{test_data_},
+                        whereIn{[](const person &p) { return p.last_name_; }, names}
+                    );
+
+    EXPECT_EQ((std::vector<std::string>{"John", "Ned", "Tyrion"}), result);
+
+    auto not_result = processLinq(
+                        from{test_data_},
+                        whereNotIn{[](const person &p) { return p.last_name_; }, names}
+                    );
+
+    EXPECT_EQ(17, not_result.size());
+    EXPECT_FALSE(existsInResult(not_result, [](const person &p) { return p.last_name_ == "Stark"; }));
+}
+
+TEST_F(LinqTest, whereInPicksStructureBySizeAndType)
+{
+    auto projection = [](int64_t value) { return value; };
+
+    // dense integer range
+    std::vector<int64_t> dense{-5, 0, 3, 100, 7, 64, 65, 500};
+    keyMembership<decltype(projection), int64_t> dense_keys{projection, dense.begin(), dense.end(), false, false};
+    EXPECT_EQ(membership_type::bitmap, dense_keys.structure());
+
+    // sparse and small
+    std::vector<int64_t> sparse{-5, 1LL << 40, 3};
+    keyMembership<decltype(projection), int64_t> sparse_keys{projection, sparse.begin(), sparse.end(), false, false};
+    EXPECT_EQ(membership_type::sorted_vector, sparse_keys.structure());
+
+    // sparse and large
+    auto large = generateValues(10000, 99);
+    keyMembership<decltype(projection), int64_t> large_keys{projection, large.begin(), large.end(), false, true};
+    EXPECT_EQ(membership_type::flat_hash, large_keys.structure());
+    EXPECT_TRUE(large_keys.bloomPrefilter());
+
+    for(auto key : dense)
+        EXPECT_TRUE(dense_keys.contains(key));
+    EXPECT_FALSE(dense_keys.contains(-6));
+    EXPECT_FALSE(dense_keys.contains(1));
+    EXPECT_FALSE(dense_keys.contains(501));
+
+    EXPECT_TRUE(sparse_keys.contains(1LL << 40));
+    EXPECT_FALSE(sparse_keys.contains(4));
+
+    for(auto key : large)
+        EXPECT_TRUE(large_keys.contains(key));
+}
+
+TEST_F(LinqTest, whereInSmallKeySetWithBloomPrefilter)
+{
+    auto projection = [](int64_t value) { return value; };
+
+    // few sparse keys are held in a sorted vector, the filter is built from them
+    std::vector<int64_t> sparse{1LL << 40, -5, 3, 1LL << 33};
+    keyMembership<decltype(projection), int64_t> sparse_keys{projection, sparse.begin(), sparse.end(), false, true};
+    EXPECT_EQ(membership_type::sorted_vector, sparse_keys.structure());
+    EXPECT_TRUE(sparse_keys.bloomPrefilter());
+
+    for(auto key : sparse)
+        EXPECT_TRUE(sparse_keys.contains(key));
+    EXPECT_FALSE(sparse_keys.contains(4));
+
+    std::vector<int64_t> data{3, 4, 1LL << 40, -5, 7, 1LL << 33, 3};
+    EXPECT_EQ((std::vector<int64_t>{3, 1LL << 40, -5, 1LL << 33, 3}),
+              processLinq(from{data}, whereIn{projection, sparse, true}));
+    EXPECT_EQ((std::vector<int64_t>{4, 7}),
+              processLinq(from{data}, whereNotIn{projection, sparse, true}));
+}
+
+TEST_F(LinqTest, whereInMatchesHashSetFilter)
+{
+    auto data = generateValues(50000, 7);
+    for(auto &value : data)
+        value %= 1000000;
+
+    // every other value of the data plus values not in the data
+    std::unordered_set<int64_t> key_set;
+    for(size_t i = 0; i < data.size(); i += 2)
+        key_set.insert(data[i]);
+    for(auto value : generateValues(1000, 8))
+        key_set.insert(value);
+
+    for(bool bloom : {false, true})
+    {
+        auto result = processLinq(
+                            from{data},
+                            whereIn{[](int64_t value) { return value; }, key_set, bloom}
+                        );
+
+        auto not_result = processLinq(
+                            from{data},
+                            whereNotIn{[](int64_t value) { return value; }, key_set, bloom}
+                        );
+
+        std::vector<int64_t> expected;
+        std::vector<int64_t> not_expected;
+        for(auto value : data)
+            (key_set.count(value) ? expected : not_expected).push_back(value);
+
+        EXPECT_EQ(expected, result);
+        EXPECT_EQ(not_expected, not_result);
+    }
+}
+
+TEST_F(LinqTest, whereInLargeSparseKeysWithBloomPrefilter)
+{
+    auto data = generateValues(20000, 11);
+
+    // few of the data values are keys, most tests are answered by the Bloom
+    // filter
+    auto keys = generateValues(5000, 12);
+    keys.push_back(data[10]);
+    keys.push_back(data[19999]);
+
+    std::set<int64_t> key_set(keys.begin(), keys.end());
+
+    auto result = processLinq(
+                        from{data},
+                        whereIn{[](int64_t value) { return value; }, key_set, true},
+                        orderBy{}
+                    );
+
+    std::vector<int64_t> expected{data[10], data[19999]};
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, whereInWithMaterializedView)
+{
+    std::vector<int> ages{14, 17, 23, 99};
+
+    materializedView view{from{test_data_},
+                          whereIn{[](const person &p) { return p.age_; }, ages}};
+
+    EXPECT_EQ(4, view.size());
+    EXPECT_FALSE(view.insert({"Hodor", "Hodor", 40, 500.00}));
+    EXPECT_TRUE(view.insert({"Arya", "Stark", 99, 100.00}));
+    EXPECT_EQ(5, view.size());
+}
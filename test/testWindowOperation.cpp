@@ -0,0 +1,164 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+#include <chrono>
+#include <numeric>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+TEST_F(LinqTest, slidingWindowAggregates)
+{
+    std::vector<int> int_data{4,2,12,3,8,1,7,7,5};
+
+    auto result = processLinq(
+                    from{int_data},
+                    window{3, 1,
+                           sumOf{[](int value) { return value; }},
+                           minOf{[](int value) { return value; }},
+                           maxOf{[](int value) { return value; }}}
+                );
+
+    // one result for each complete window
+    ASSERT_EQ(7, result.size());
+
+    // confirm each window against a direct calculation
+    for(size_t i = 0; i < result.size(); ++i)
+    {
+        auto first = int_data.begin() + i;
+        auto last = first + 3;
+
+        EXPECT_EQ(i, result[i].first_);
+        EXPECT_EQ(3, result[i].count_);
+        EXPECT_EQ(std::accumulate(first, last, 0), result[i].aggregate<0>());
+        EXPECT_EQ(*std::min_element(first, last), result[i].aggregate<1>());
+        EXPECT_EQ(*std::max_element(first, last), result[i].aggregate<2>());
+    }
+}
+
+TEST_F(LinqTest, tumblingWindowWithExtract)
+{
+    auto result = processLinq(
+                    extract{[](const auto &w) { return w.template aggregate<0>(); }},
+                    from{test_data_},
+                    window{5, 5, sumOf{[](const person &p) { return p.age_; }}}
+                );
+
+    // confirm correct size
+    ASSERT_EQ(4, result.size());
+
+    // confirm the sum of ages in each window
+    EXPECT_EQ(196, result[0]);
+    EXPECT_EQ(168, result[1]);
+    EXPECT_EQ(146, result[2]);
+    EXPECT_EQ(175, result[3]);
+}
+
+TEST_F(LinqTest, windowWithSlideLargerThanSize)
+{
+    std::vector<int> int_data{1,2,3,4,5,6,7,8};
+
+    auto result = processLinq(
+                    from{int_data},
+                    where{[](int value) { return value != 8; }},
+                    window{2, 3, maxOf{[](int value) { return value; }}}
+                );
+
+    // windows {1,2} {4,5} {7} is incomplete
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(0, result[0].first_);
+    EXPECT_EQ(2, result[0].aggregate<0>());
+    EXPECT_EQ(3, result[1].first_);
+    EXPECT_EQ(5, result[1].aggregate<0>());
+}
+
+TEST_F(LinqTest, windowLargerThanData)
+{
+    auto result = processLinq(
+                    from{test_data_},
+                    window{21, 1, sumOf{[](const person &p) { return p.salary_; }}}
+                );
+
+    EXPECT_EQ(0, result.size());
+
+    EXPECT_THROW(window(0, 1), std::invalid_argument);
+    EXPECT_THROW(window(1, 0), std::invalid_argument);
+}
+
+TEST_F(LinqTest, timeWindowAggregates)
+{
+    struct reading
+    {
+        double time_;
+        double value_;
+    };
+
+    std::vector<reading> readings{{0.0, 5.0}, {1.0, 3.0}, {2.5, 9.0}, {3.0, 1.0}, {7.0, 2.0}, {7.5, 4.0}};
+
+    auto result = processLinq(
+                    from{readings},
+                    timeWindow{[](const reading &r) { return r.time_; }, 3.0,
+                               sumOf{[](const reading &r) { return r.value_; }},
+                               maxOf{[](const reading &r) { return r.value_; }}}
+                );
+
+    // one window ending at each reading
+    ASSERT_EQ(6, result.size());
+
+    // (0.0, 3.0] holds the readings at 1.0, 2.5 and 3.0
+    EXPECT_EQ(1, result[3].first_);
+    EXPECT_EQ(3, result[3].count_);
+    EXPECT_DOUBLE_EQ(13.0, result[3].aggregate<0>());
+    EXPECT_DOUBLE_EQ(9.0, result[3].aggregate<1>());
+
+    // (4.0, 7.0] holds only the reading at 7.0
+    EXPECT_EQ(4, result[4].first_);
+    EXPECT_EQ(1, result[4].count_);
+    EXPECT_DOUBLE_EQ(2.0, result[4].aggregate<1>());
+
+    EXPECT_EQ(2, result[5].count_);
+    EXPECT_DOUBLE_EQ(6.0, result[5].aggregate<0>());
+    EXPECT_DOUBLE_EQ(4.0, result[5].aggregate<1>());
+}
+
+TEST_F(LinqTest, timeWindowWithChronoTimestamps)
+{
+    using namespace std::chrono;
+
+    struct sample
+    {
+        steady_clock::time_point time_;
+        int value_;
+    };
+
+    auto start = steady_clock::time_point{};
+    std::vector<sample> samples{{start, 1}, {start + seconds{10}, 2}, {start + seconds{50}, 3},
+                                {start + seconds{65}, 4}, {start + seconds{70}, 5}};
+
+    auto result = processLinq(
+                    extract{[](const auto &w) { return w.count_; }},
+                    from{samples},
+                    timeWindow{[](const sample &s) { return s.time_; }, seconds{60},
+                               minOf{[](const sample &s) { return s.value_; }}}
+                );
+
+    EXPECT_EQ((std::vector<size_t>{1, 2, 3, 3, 3}), result);
+}
+
+TEST_F(LinqTest, timeWindowWithUnsignedTimestamps)
+{
+    std::vector<uint64_t> timestamps{1, 2, 5, 20};
+
+    // timestamps smaller than the duration start their window at 0
+    auto result = processLinq(
+                    extract{[](const auto &w) { return w.count_; }},
+                    from{timestamps},
+                    timeWindow{[](uint64_t t) { return t; }, uint64_t{10},
+                               maxOf{[](uint64_t t) { return t; }}}
+                );
+
+    EXPECT_EQ((std::vector<size_t>{1, 2, 3, 1}), result);
+}
@@ -0,0 +1,185 @@
+#include "linqcppTestFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <linqcpp.h>
+
+using namespace linqcpp_test_fixture;
+using namespace linqcpp;
+
+namespace
+{
+    struct logEntry
+    {
+        int64_t time_;
+        int level_;
+
+        bool operator==(const logEntry &rhs) const { return time_ == rhs.time_ && level_ == rhs.level_; }
+    };
+
+    // time ordered log entries with a little jitter in the times
+    std::vector<logEntry> generateLog(size_t count)
+    {
+        std::vector<logEntry> log;
+        uint64_t state = 777;
+        for(size_t i = 0; i < count; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            log.push_back({static_cast<int64_t>(i * 10 + (state >> 60)), static_cast<int>((state >> 33) % 5)});
+        }
+
+        return log;
+    }
+
+    template<typename PT>
+    std::vector<logEntry> scan(const std::vector<logEntry> &log, PT predicate)
+    {
+        std::vector<logEntry> expected;
+        std::copy_if(log.begin(), log.end(), std::back_inserter(expected), predicate);
+        return expected;
+    }
+}
+
+TEST_F(LinqTest, zoneMapRangeSkipsBlocks)
+{
+    auto log = generateLog(100000);
+
+    zoneMap time_zones{log, [](const logEntry &e) { return e.time_; }, 1024};
+
+    EXPECT_EQ(98, time_zones.blocks());
+
+    auto lookup = time_zones.between(250000, 260000);
+
+    // the range covers about a thousand entries so touches two blocks
+    EXPECT_LE(time_zones.scannedBlocks(lookup.bounds_), 3);
+
+    auto result = processLinq(from{time_zones.source()}, where{time_zones.between(250000, 260000)});
+
+    EXPECT_EQ(scan(log, [](const logEntry &e) { return e.time_ >= 250000 && e.time_ <= 260000; }), result);
+    EXPECT_FALSE(result.empty());
+}
+
+TEST_F(LinqTest, zoneMapOpenAndExclusiveBounds)
+{
+    auto log = generateLog(20000);
+
+    zoneMap time_zones{log, [](const logEntry &e) { return e.time_; }, 512};
+
+    auto time = log[7000].time_;
+
+    EXPECT_EQ(scan(log, [time](const logEntry &e) { return e.time_ < time; }),
+              processLinq(from{time_zones.source()}, where{time_zones.lessThan(time)}));
+
+    EXPECT_EQ(scan(log, [time](const logEntry &e) { return e.time_ <= time; }),
+              processLinq(from{time_zones.source()}, where{time_zones.atMost(time)}));
+
+    EXPECT_EQ(scan(log, [time](const logEntry &e) { return e.time_ > time; }),
+              processLinq(from{time_zones.source()}, where{time_zones.greaterThan(time)}));
+
+    EXPECT_EQ(scan(log, [time](const logEntry &e) { return e.time_ >= time; }),
+              processLinq(from{time_zones.source()}, where{time_zones.atLeast(time)}));
+
+    EXPECT_EQ(scan(log, [time](const logEntry &e) { return e.time_ == time; }),
+              processLinq(from{time_zones.source()}, where{time_zones.equalTo(time)}));
+
+    // nothing before the first entry
+    EXPECT_EQ(0, time_zones.scannedBlocks(time_zones.lessThan(log.front().time_).bounds_));
+}
+
+TEST_F(LinqTest, zoneMapUnorderedFieldWithFollowingOperations)
+{
+    auto log = generateLog(10000);
+
+    zoneMap level_zones{log, [](const logEntry &e) { return e.level_; }, 256};
+
+    // the levels are not ordered so no block can be skipped, the results are
+    // still those of a scan
+    auto result = processLinq(
+                        extract{[](const logEntry &e) { return e.time_; }},
+                        from{level_zones.source()},
+                        where{level_zones.equalTo(4)},
+                        where{[](const logEntry &e) { return e.time_ % 2 == 0; }},
+                        top{10}
+                    );
+
+    std::vector<int64_t> expected;
+    for(const auto &entry : log)
+    {
+        if(entry.level_ == 4 && entry.time_ % 2 == 0 && expected.size() < 10)
+            expected.push_back(entry.time_);
+    }
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(LinqTest, zoneMapUpdatedForAppendedElements)
+{
+    zoneMap age_zones{test_data_, [](const person &p) { return p.age_; }, 8};
+
+    EXPECT_EQ(3, age_zones.blocks());
+
+    test_data_.push_back({"Arya", "Stark", 11, 100.00});
+    test_data_.push_back({"Sansa", "Stark", 13, 200.00});
+
+    // stale, the where tests each element
+    EXPECT_EQ(4, processLinq(from{age_zones.source()}, where{age_zones.lessThan(15)}).size());
+
+    age_zones.update();
+    EXPECT_EQ(22, age_zones.size());
+    EXPECT_EQ(3, age_zones.blocks());
+
+    auto result = processLinq(from{age_zones.source()}, where{age_zones.lessThan(15)});
+    ASSERT_EQ(4, result.size());
+    EXPECT_EQ("Meera", result[0].first_name_);
+    EXPECT_EQ("Sansa", result[3].first_name_);
+
+    EXPECT_EQ(processLinq(from{test_data_}, where{[](const person &p) { return p.age_ >= 60; }}),
+              processLinq(from{age_zones.source()}, where{age_zones.atLeast(60)}));
+}
+
+namespace
+{
+    // a log entry that counts the copies made of it
+    struct countedEntry
+    {
+        int64_t time_;
+
+        countedEntry(int64_t time) :time_(time) { }
+        countedEntry(const countedEntry &other) :time_(other.time_) { ++copies_; }
+        countedEntry &operator=(const countedEntry &other) { time_ = other.time_; ++copies_; return *this; }
+        countedEntry(countedEntry&&) = default;
+        countedEntry &operator=(countedEntry&&) = default;
+
+        static inline size_t copies_ = 0;
+    };
+}
+
+TEST_F(LinqTest, zoneMapReadsKeptBlocksFromItsSource)
+{
+    std::vector<countedEntry> log;
+    log.reserve(10000);
+    for(int64_t time = 0; time < 10000; ++time)
+        log.emplace_back(time);
+
+    zoneMap time_zones{log, [](const countedEntry &e) { return e.time_; }, 256};
+
+    // only the matches of the two blocks the range touches are copied
+    countedEntry::copies_ = 0;
+    auto result = processLinq(from{time_zones.source()}, where{time_zones.between(1000, 1099)});
+
+    ASSERT_EQ(100, result.size());
+    EXPECT_EQ(1000, result.front().time_);
+    EXPECT_EQ(1099, result.back().time_);
+    EXPECT_EQ(100, countedEntry::copies_);
+
+    // other data of the same size is scanned, not taken from the source
+    auto other = generateLog(10000);
+    zoneMap other_zones{other, [](const logEntry &e) { return e.time_; }, 256};
+    auto shifted = other;
+    for(auto &entry : shifted)
+        entry.time_ += 50;
+
+    EXPECT_FALSE(other_zones.between(1000, 1099).current(shifted));
+    EXPECT_EQ(scan(shifted, [](const logEntry &e) { return e.time_ >= 1000 && e.time_ <= 1099; }),
+              processLinq(from{shifted}, where{other_zones.between(1000, 1099)}));
+}